@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHANNEL_HPP
+#define CHANNEL_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// In-process "latest value" channel between components. Values are passed as
+// shared pointers to immutable data, so any number of readers can use the
+// same frame or detection without copying it. Like an OD4 data trigger, a
+// slow reader skips to the newest value instead of queueing.
+template <typename T>
+class Channel {
+ private:
+  Channel(Channel const &) = delete;
+  Channel(Channel &&) = delete;
+  Channel &operator=(Channel const &) = delete;
+  Channel &operator=(Channel &&) = delete;
+
+ public:
+  Channel() noexcept
+    : m_mutex{}
+    , m_newValue{}
+    , m_value{}
+    , m_sequence{0}
+    , m_isClosed{false}
+  {
+  }
+
+  void publish(std::shared_ptr<T const> value) noexcept {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_value = std::move(value);
+      m_sequence++;
+    }
+    m_newValue.notify_all();
+  }
+
+  // The newest value, or nullptr if nothing has been published yet.
+  std::shared_ptr<T const> latest() noexcept {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_value;
+  }
+
+  // Blocks until a value newer than the given sequence number is published
+  // and updates the sequence number. Returns nullptr once the channel is
+  // closed.
+  std::shared_ptr<T const> waitForNewer(uint64_t &sequence) noexcept {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_newValue.wait(lock, [this, &sequence]() { return m_isClosed || m_sequence != sequence; });
+    if (m_isClosed) {
+      return nullptr;
+    }
+    sequence = m_sequence;
+    return m_value;
+  }
+
+  void close() noexcept {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_isClosed = true;
+    }
+    m_newValue.notify_all();
+  }
+
+ private:
+  std::mutex m_mutex;
+  std::condition_variable m_newValue;
+  std::shared_ptr<T const> m_value;
+  uint64_t m_sequence;
+  bool m_isClosed;
+};
+
+#endif
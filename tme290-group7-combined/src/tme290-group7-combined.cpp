@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cluon-complete.hpp"
+#include "opendlv-standard-message-set.hpp"
+#include "od4-bus.hpp"
+#include "channel.hpp"
+#include "cone-detector.hpp"
+#include "kiwi-detector.hpp"
+#include "logic-controller.hpp"
+#include "perception-arrays.hpp"
+#include "scheduling.hpp"
+#include "async-log.hpp"
+#include "metrics.hpp"
+#include "metrics-server.hpp"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// A camera frame with the time stamp of the shared memory, which every
+// message derived from the frame carries as its sample time.
+struct CameraFrame {
+  cv::Mat image{};
+  cluon::data::TimeStamp sampleTime{};
+};
+
+int32_t main(int32_t argc, char **argv) {
+  int32_t retCode{1};
+  auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+  if ( (0 == commandlineArguments.count("cid")) ||
+       (0 == commandlineArguments.count("name")) ||
+       (0 == commandlineArguments.count("width")) ||
+       (0 == commandlineArguments.count("height")) ||
+       (0 == commandlineArguments.count("freq")) ) {
+    std::cerr << argv[0] << " runs cone detection, Kiwi detection and the control logic in one process." << std::endl;
+    std::cerr << "Usage:   " << argv[0] << " --cid=<OD4 session> --name=<name of shared memory area> --width=<w> --height=<h> --freq=<Hz> [--od4-tap [--legacy-messages]] [--shm-bus] [--udp-batch] [--metrics-port=<port>] [--cpus=<list>] [--threads=<n>] [--rt-priority=<1..99>] [--scheduling-config=<file>] [--verbose]" << std::endl;
+    std::cerr << "         --cid:     CID of the OD4Session to send and receive messages" << std::endl;
+    std::cerr << "         --name:    name of the shared memory area to attach" << std::endl;
+    std::cerr << "         --width:   width of the frame" << std::endl;
+    std::cerr << "         --height:  height of the frame" << std::endl;
+    std::cerr << "         --freq:    frequency of the control logic" << std::endl;
+    std::cerr << "         --od4-tap: also send the ConeArray and KiwiBoundingBoxArray messages for observability" << std::endl;
+    std::cerr << "         --legacy-messages: with --od4-tap, also send NearFarPoints and one KiwiBoundingBox per box" << std::endl;
+    std::cerr << "         --shm-bus: exchange messages with local services over shared memory (UDP is kept)" << std::endl;
+    std::cerr << "         --udp-batch: read UDP with several datagrams per system call" << std::endl;
+    std::cerr << "         --metrics-port: serve the metrics on this TCP port (Prometheus text format, or JSON for /metrics.json)" << std::endl;
+    std::cerr << "         --cpus: run on these cores only, e.g. 2-3 or 0,2" << std::endl;
+    std::cerr << "         --threads: number of OpenCV and network worker threads" << std::endl;
+    std::cerr << "         --rt-priority: run the control loop with SCHED_FIFO at this priority (1 to 99; needs CAP_SYS_NICE)" << std::endl;
+    std::cerr << "         --scheduling-config: file with the settings above for all services (<service>.cpus=..., <service>.threads=..., <service>.rt-priority=...); the flags take precedence" << std::endl;
+    std::cerr << "Example: " << argv[0] << " --cid=111 --name=video0.argb --width=1280 --height=720 --freq=10 --od4-tap" << std::endl;
+  }
+  else {
+    const std::string NAME{commandlineArguments["name"]};
+    const uint32_t WIDTH{static_cast<uint32_t>(std::stoi(commandlineArguments["width"]))};
+    const uint32_t HEIGHT{static_cast<uint32_t>(std::stoi(commandlineArguments["height"]))};
+    const float FREQ{std::stof(commandlineArguments["freq"])};
+    const bool OD4_TAP{commandlineArguments.count("od4-tap") != 0};
+    const bool LEGACY_MESSAGES{commandlineArguments.count("legacy-messages") != 0};
+    const bool VERBOSE{commandlineArguments.count("verbose") != 0};
+    const bool SHM_BUS{commandlineArguments.count("shm-bus") != 0};
+    const bool UDP_BATCH{commandlineArguments.count("udp-batch") != 0};
+    const uint16_t METRICS_PORT{static_cast<uint16_t>((commandlineArguments.count("metrics-port") != 0) ?
+      std::stoi(commandlineArguments["metrics-port"]) : 0)};
+    const Scheduling SCHEDULING{schedulingFrom("combined", commandlineArguments)};
+    pinThread(SCHEDULING.cpus);
+    if (SCHEDULING.threads > 0) {
+      cv::setNumThreads(SCHEDULING.threads);
+    }
+
+    // Attach to the shared memory.
+    std::unique_ptr<cluon::SharedMemory> sharedMemory{new cluon::SharedMemory{NAME}};
+    if (sharedMemory && sharedMemory->valid()) {
+      std::clog << argv[0] << ": Attached to shared memory '" << sharedMemory->name() << " (" << sharedMemory->size() << " bytes)." << std::endl;
+
+      // Only the actuation requests (and the optional taps) go to OD4.
+      Od4Bus od4{static_cast<uint16_t>(std::stoi(commandlineArguments["cid"])), SHM_BUS, UDP_BATCH};
+
+      ConeDetector coneDetector{WIDTH, HEIGHT};
+      KiwiDetector kiwiDetector{"/opt/yolo/yolo-obj.cfg", "/opt/yolo/yolo-obj.weights"};
+      LogicController controller;
+
+      // Shared by the detection threads and the control loop, none of which
+      // waits for the terminal.
+      AsyncLog log{argv[0]};
+      asynclog::Site inferenceLog{"Inference time for a frame : {} ms"};
+      asynclog::Site kiwiSpeedControlLog{"kiwi speed control activated", 1000};
+      asynclog::Site requestLog{"Ground steering is {} and pedal position is {}"};
+      asynclog::Site overrunLog{"Control tick overran its period ({} times in total).", 1000};
+
+      // Updated by all threads, read by the metrics server's when asked.
+      Metrics metrics;
+      Histogram &cameraLockHolds{metrics.histogram("combined_camera_lock_hold_ms", "Time the camera shared memory is held locked per frame")};
+      Histogram &coneProcessingTimes{metrics.histogram("combined_cone_processing_ms", "Time to find the cones and the near and far points of a frame")};
+      Histogram &inferenceTimes{metrics.histogram("combined_kiwi_inference_ms", "Forward time of the Kiwi network per frame")};
+      Counter &ticks{metrics.counter("combined_ticks_total", "Control ticks run")};
+      Histogram &periodErrors{metrics.histogram("combined_period_error_ms", "Deviation of the time between two control ticks from the period")};
+      Histogram &tickDurations{metrics.histogram("combined_tick_duration_ms", "Time to compute and send the requests of a control tick")};
+      Counter &overruns{metrics.counter("combined_tick_overruns_total", "Control ticks that overran their period")};
+      std::unique_ptr<MetricsServer> metricsServer{(METRICS_PORT > 0) ? new MetricsServer{METRICS_PORT, metrics} : nullptr};
+      if (metricsServer && !metricsServer->valid()) {
+        std::cerr << argv[0] << ": Could not serve the metrics on port " << METRICS_PORT << "." << std::endl;
+      }
+
+      // The components are wired by in-process channels instead of OD4.
+      Channel<CameraFrame> frames;
+      Channel<opendlv::perception::cognition::NearFarPoints> nearFarPoints;
+      Channel<opendlv::perception::KiwiBoundingBoxArray> kiwiBoundingBoxes;
+
+      // Each camera frame is copied out of the shared memory once and then
+      // shared read-only by both detectors. The thread is joined before
+      // anything it uses goes out of scope.
+      std::atomic<bool> isAcquiring{true};
+      std::atomic<bool> hasAcquisitionEnded{false};
+      std::thread acquisition([&sharedMemory, &od4, &frames, &cameraLockHolds, &isAcquiring, &hasAcquisitionEnded,
+          WIDTH, HEIGHT]() {
+          while (isAcquiring.load() && od4.isRunning()) {
+            sharedMemory->wait();
+            if (!isAcquiring.load()) {
+              break;
+            }
+
+            std::shared_ptr<CameraFrame> frame{new CameraFrame};
+            sharedMemory->lock();
+            {
+              Stopwatch const held;
+              cv::Mat wrapped(HEIGHT, WIDTH, CV_8UC4, sharedMemory->data());
+              frame->image = wrapped.clone();
+              frame->sampleTime = sharedMemory->getTimeStamp().second;
+              cameraLockHolds.observe(held.elapsed());
+            }
+            sharedMemory->unlock();
+
+            frames.publish(frame);
+          }
+          hasAcquisitionEnded.store(true);
+        });
+
+      std::thread coneDetection([&coneDetector, &frames, &nearFarPoints, &od4, &coneProcessingTimes, OD4_TAP, LEGACY_MESSAGES,
+          WIDTH, HEIGHT]() {
+          uint64_t sequence{0};
+          uint32_t frameId{0};
+          Od4Batch tap{od4};
+          while (auto frame = frames.waitForNewer(sequence)) {
+            // The annotations are drawn into a private copy of the lower half.
+            cv::Mat img = frame->image(coneDetector.regionOfInterest()).clone();
+            Stopwatch const processing;
+            std::shared_ptr<opendlv::perception::cognition::NearFarPoints> nfPoints{
+              new opendlv::perception::cognition::NearFarPoints(coneDetector.process(img))};
+            coneProcessingTimes.observe(processing.elapsed());
+            nearFarPoints.publish(nfPoints);
+
+            if (OD4_TAP) {
+              opendlv::perception::ConeArray coneArray = toConeArray(*nfPoints, coneDetector.cones(), frameId++,
+                  cluon::time::toMicroseconds(frame->sampleTime), WIDTH, HEIGHT);
+              tap.add(coneArray, frame->sampleTime, 0);
+              if (LEGACY_MESSAGES) {
+                tap.add(*nfPoints, frame->sampleTime, 0);
+              }
+              tap.send();
+            }
+          }
+        });
+
+      std::thread kiwiDetection([&kiwiDetector, &coneDetector, &frames, &kiwiBoundingBoxes, &od4, &log, &inferenceLog,
+          &inferenceTimes, OD4_TAP, LEGACY_MESSAGES, VERBOSE, WIDTH, HEIGHT]() {
+          uint64_t sequence{0};
+          uint32_t frameId{0};
+          Od4Batch tap{od4};
+          while (auto frame = frames.waitForNewer(sequence)) {
+            std::vector<cv::Rect> boxes = kiwiDetector.detect(frame->image);
+            inferenceTimes.observe(kiwiDetector.inferenceTime());
+            cluon::data::TimeStamp const &sampleTime{frame->sampleTime};
+            std::shared_ptr<opendlv::perception::KiwiBoundingBoxArray> kiwis{
+              new opendlv::perception::KiwiBoundingBoxArray(toKiwiBoundingBoxArray(boxes, frameId++,
+                    cluon::time::toMicroseconds(sampleTime), WIDTH, HEIGHT))};
+            kiwiBoundingBoxes.publish(kiwis);
+
+            // As in the separate services, the nearest Kiwi of the frame is
+            // masked out by the cone detection.
+            auto const kiwi = nearestKiwiBoundingBox(*kiwis);
+            coneDetector.kiwiBoundingBox(kiwi.x(), kiwi.y(), kiwi.w(), kiwi.h());
+
+            if (OD4_TAP) {
+              tap.add(*kiwis, sampleTime, 0);
+              if (LEGACY_MESSAGES) {
+                for (auto k : toKiwiBoundingBoxes(boxes, WIDTH, HEIGHT)) {
+                  tap.add(k, sampleTime, 0);
+                }
+              }
+              tap.send();
+            }
+            if (VERBOSE) {
+              log.log(inferenceLog, kiwiDetector.inferenceTime());
+            }
+          }
+        });
+
+      // wait for the simulation to start
+      std::this_thread::sleep_for(std::chrono::seconds(12));
+
+      Od4Batch requests{od4};
+      double const PERIOD_MS{1000.0 / FREQ};
+      std::unique_ptr<Stopwatch> sinceLastTick;
+      auto atFrequency{[&VERBOSE, &controller, &nearFarPoints, &kiwiBoundingBoxes, &requests, &log, &kiwiSpeedControlLog,
+        &requestLog, &overrunLog, &od4, &ticks, &periodErrors, &tickDurations, &overruns, &sinceLastTick, &PERIOD_MS]() -> bool
+        {
+          Stopwatch const tick;
+          uint64_t const overrunCount{od4.overruns()};
+          if (overrunCount > overruns.value()) {
+            overruns.add(overrunCount - overruns.value());
+            log.log(overrunLog, overrunCount);
+          }
+          if (sinceLastTick) {
+            periodErrors.observe(std::fabs(sinceLastTick->elapsed() - PERIOD_MS));
+            sinceLastTick->restart();
+          } else {
+            sinceLastTick.reset(new Stopwatch);
+          }
+          opendlv::perception::cognition::NearFarPoints nfPointsReading;
+          opendlv::perception::KiwiBoundingBox kiwiBoundingBox;
+          if (auto nfPoints = nearFarPoints.latest()) {
+            nfPointsReading = *nfPoints;
+          }
+          if (auto kiwis = kiwiBoundingBoxes.latest()) {
+            kiwiBoundingBox = nearestKiwiBoundingBox(*kiwis);
+          }
+
+          auto request = controller.step(nfPointsReading, kiwiBoundingBox);
+          if (controller.isFollowingKiwi()) {
+            log.log(kiwiSpeedControlLog);
+          }
+
+          cluon::data::TimeStamp sampleTime = cluon::time::now();
+          requests.add(request.first, sampleTime, 0);
+          requests.add(request.second, sampleTime, 0);
+          requests.send();
+          ticks.add();
+          tickDurations.observe(tick.elapsed());
+
+          if (VERBOSE) {
+            log.log(requestLog, request.first.groundSteering(), request.second.position());
+          }
+          return true;
+        }};
+
+      // The detection threads are running already, so only the control
+      // loop gets the real-time priority.
+      setRealtimePriority(SCHEDULING.priority);
+      od4.timeTrigger(FREQ, atFrequency);
+
+      // The thread may have checked the flag just before waiting, so it is
+      // woken until it has seen it.
+      isAcquiring.store(false);
+      while (!hasAcquisitionEnded.load()) {
+        sharedMemory->notifyAll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      acquisition.join();
+
+      frames.close();
+      coneDetection.join();
+      kiwiDetection.join();
+    }
+    retCode = 0;
+  }
+  return retCode;
+}
@@ -0,0 +1,349 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ASYNC_LOG_HPP
+#define ASYNC_LOG_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace asynclog {
+
+// A value of a log record, kept as it was passed; it is only turned into
+// text by the drain thread. Text has to be a string literal (or otherwise
+// outlive the logger), as only the pointer is kept.
+class Argument {
+ public:
+  enum class Kind : uint8_t { NONE, INTEGER, UNSIGNED, REAL, BOOLEAN, TEXT };
+
+  Argument() noexcept
+    : m_kind{Kind::NONE}
+    , m_value{}
+  {
+  }
+
+  template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, int32_t>::type = 0>
+  Argument(T value) noexcept
+    : m_kind{Kind::INTEGER}
+    , m_value{}
+  {
+    m_value.integer = value;
+  }
+
+  template <typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value
+    && !std::is_same<T, bool>::value, int32_t>::type = 0>
+  Argument(T value) noexcept
+    : m_kind{Kind::UNSIGNED}
+    , m_value{}
+  {
+    m_value.natural = value;
+  }
+
+  template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int32_t>::type = 0>
+  Argument(T value) noexcept
+    : m_kind{Kind::REAL}
+    , m_value{}
+  {
+    m_value.real = value;
+  }
+
+  Argument(bool value) noexcept
+    : m_kind{Kind::BOOLEAN}
+    , m_value{}
+  {
+    m_value.natural = value ? 1 : 0;
+  }
+
+  Argument(char const *value) noexcept
+    : m_kind{Kind::TEXT}
+    , m_value{}
+  {
+    m_value.text = value;
+  }
+
+  void appendTo(std::string &out) const {
+    switch (m_kind) {
+      case Kind::INTEGER: out += std::to_string(m_value.integer); break;
+      case Kind::UNSIGNED: out += std::to_string(m_value.natural); break;
+      case Kind::REAL: {
+        char buffer[32];
+        int32_t const length{std::snprintf(buffer, sizeof(buffer), "%g", m_value.real)};
+        out.append(buffer, static_cast<size_t>(std::max(length, 0)));
+        break;
+      }
+      case Kind::BOOLEAN: out += (m_value.natural != 0) ? "true" : "false"; break;
+      case Kind::TEXT: out += (m_value.text != nullptr) ? m_value.text : "(null)"; break;
+      case Kind::NONE: break;
+    }
+  }
+
+ private:
+  Kind m_kind;
+  union {
+    int64_t integer;
+    uint64_t natural;
+    double real;
+    char const *text;
+  } m_value;
+};
+
+// A place in the code that logs, with its format ("{}" for each argument)
+// and the shortest time between two of its records. Records that come
+// sooner are only counted, and the count is printed with the next record
+// that goes out. A site is usually a static or a member next to the code
+// that logs, and has to outlive the logger.
+class Site {
+ private:
+  Site(Site const &) = delete;
+  Site(Site &&) = delete;
+  Site &operator=(Site const &) = delete;
+  Site &operator=(Site &&) = delete;
+
+ public:
+  explicit Site(char const *format, uint32_t minIntervalMs = 0) noexcept
+    : m_format{format}
+    , m_minIntervalUs{static_cast<int64_t>(minIntervalMs) * 1000}
+    , m_nextUs{0}
+    , m_suppressed{0}
+  {
+  }
+
+  char const *format() const noexcept {
+    return m_format;
+  }
+
+  // Whether a record may go out at nowUs; if so, suppressed is the number
+  // of records held back since the last one.
+  bool admit(int64_t nowUs, uint32_t &suppressed) noexcept {
+    if (m_minIntervalUs > 0) {
+      int64_t next{m_nextUs.load(std::memory_order_relaxed)};
+      if (nowUs < next || !m_nextUs.compare_exchange_strong(next, nowUs + m_minIntervalUs, std::memory_order_relaxed)) {
+        m_suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+    }
+    suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+  }
+
+ private:
+  char const *m_format;
+  int64_t const m_minIntervalUs;
+  std::atomic<int64_t> m_nextUs;
+  std::atomic<uint32_t> m_suppressed;
+};
+
+uint32_t const MAX_ARGUMENTS{8};
+
+// One fixed-size binary record in the ring: the site, and the arguments as
+// they were passed.
+struct Record {
+  Site const *site{nullptr};
+  uint32_t suppressed{0};
+  uint32_t count{0};
+  Argument arguments[MAX_ARGUMENTS];
+};
+
+// Renders the format of a record, with its arguments in place of the "{}".
+inline void render(Record const &record, std::string &out) {
+  char const *format{record.site->format()};
+  uint32_t next{0};
+  for (char const *c = format; *c != '\0'; c++) {
+    if (c[0] == '{' && c[1] == '}' && next < record.count) {
+      record.arguments[next++].appendTo(out);
+      c++;
+    } else {
+      out += *c;
+    }
+  }
+  if (record.suppressed > 0) {
+    out += " (";
+    out += std::to_string(record.suppressed);
+    out += " more suppressed)";
+  }
+}
+
+}
+
+// Logging that never blocks the thread that logs. A record is the site and
+// its arguments in binary, put into a bounded lock-free ring that any thread
+// may write to; a background thread takes the records out every few
+// milliseconds, turns them into text and writes them all at once. When the
+// ring is full, records are dropped and counted instead of waiting for the
+// terminal or the container log.
+class AsyncLog {
+ private:
+  AsyncLog(AsyncLog const &) = delete;
+  AsyncLog(AsyncLog &&) = delete;
+  AsyncLog &operator=(AsyncLog const &) = delete;
+  AsyncLog &operator=(AsyncLog &&) = delete;
+
+  // A slot of the ring, after Vyukov's bounded queue: its sequence tells
+  // whether it is free for the writer at that position or holds a record
+  // for the reader.
+  struct Slot {
+    std::atomic<uint64_t> sequence{0};
+    asynclog::Record record{};
+  };
+
+ public:
+  // prefix is put in front of every line, like argv[0] in the other logs.
+  // capacity is rounded up to a power of two.
+  explicit AsyncLog(std::string const &prefix, std::ostream &out = std::clog, size_t capacity = 1024,
+      uint32_t drainIntervalMs = 20)
+    : m_prefix{prefix}
+    , m_out(out)
+    , m_capacity{roundUp(capacity)}
+    , m_slots{new Slot[m_capacity]}
+    , m_writePosition{0}
+    , m_readPosition{0}
+    , m_dropped{0}
+    , m_reportedDropped{0}
+    , m_drainInterval{drainIntervalMs}
+    , m_isRunning{true}
+    , m_text{}
+    , m_drain{}
+  {
+    for (size_t i = 0; i < m_capacity; i++) {
+      m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_drain = std::thread{&AsyncLog::drainLoop, this};
+  }
+
+  ~AsyncLog() {
+    m_isRunning.store(false);
+    if (m_drain.joinable()) {
+      m_drain.join();
+    }
+    drain();
+  }
+
+  // Logs a record for site, unless the site is rate limited or the ring is
+  // full; never blocks.
+  template <typename... Arguments>
+  bool log(asynclog::Site &site, Arguments const &... arguments) noexcept {
+    static_assert(sizeof...(Arguments) <= asynclog::MAX_ARGUMENTS, "Too many arguments for a log record");
+    int64_t const nowUs{std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count()};
+    uint32_t suppressed{0};
+    if (!site.admit(nowUs, suppressed)) {
+      return false;
+    }
+
+    uint64_t position{m_writePosition.load(std::memory_order_relaxed)};
+    Slot *slot{nullptr};
+    while (true) {
+      slot = &m_slots[position & (m_capacity - 1)];
+      uint64_t const sequence{slot->sequence.load(std::memory_order_acquire)};
+      int64_t const difference{static_cast<int64_t>(sequence) - static_cast<int64_t>(position)};
+      if (difference == 0) {
+        if (m_writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        position = m_writePosition.load(std::memory_order_relaxed);
+      }
+    }
+    slot->record.site = &site;
+    slot->record.suppressed = suppressed;
+    slot->record.count = static_cast<uint32_t>(sizeof...(Arguments));
+    fill(slot->record.arguments, arguments...);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Records that were dropped as the ring was full.
+  uint64_t dropped() const noexcept {
+    return m_dropped.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static size_t roundUp(size_t capacity) noexcept {
+    size_t size{2};
+    while (size < capacity) {
+      size *= 2;
+    }
+    return size;
+  }
+
+  static void fill(asynclog::Argument *) noexcept {
+  }
+
+  template <typename First, typename... Rest>
+  static void fill(asynclog::Argument *out, First const &first, Rest const &... rest) noexcept {
+    *out = asynclog::Argument{first};
+    fill(out + 1, rest...);
+  }
+
+  void drainLoop() {
+    while (m_isRunning.load(std::memory_order_relaxed)) {
+      std::this_thread::sleep_for(m_drainInterval);
+      drain();
+    }
+  }
+
+  // Only called by the drain thread, or after it has stopped.
+  void drain() {
+    m_text.clear();
+    while (true) {
+      Slot &slot = m_slots[m_readPosition & (m_capacity - 1)];
+      if (slot.sequence.load(std::memory_order_acquire) != m_readPosition + 1) {
+        break;
+      }
+      m_text += m_prefix;
+      m_text += ": ";
+      asynclog::render(slot.record, m_text);
+      m_text += '\n';
+      slot.sequence.store(m_readPosition + m_capacity, std::memory_order_release);
+      m_readPosition++;
+    }
+    uint64_t const dropped{m_dropped.load(std::memory_order_relaxed)};
+    if (dropped != m_reportedDropped) {
+      m_text += m_prefix + ": " + std::to_string(dropped - m_reportedDropped) + " log record(s) dropped, the log is behind.\n";
+      m_reportedDropped = dropped;
+    }
+    if (!m_text.empty()) {
+      m_out << m_text << std::flush;
+    }
+  }
+
+  std::string const m_prefix;
+  std::ostream &m_out;
+  size_t const m_capacity;
+  std::unique_ptr<Slot[]> m_slots;
+  std::atomic<uint64_t> m_writePosition;
+  uint64_t m_readPosition;
+  std::atomic<uint64_t> m_dropped;
+  uint64_t m_reportedDropped;
+  std::chrono::milliseconds const m_drainInterval;
+  std::atomic<bool> m_isRunning;
+  std::string m_text;
+  std::thread m_drain;
+};
+
+#endif
@@ -0,0 +1,557 @@
+/*
+ * Copyright (C) 2018  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONE_DETECTOR_HPP
+#define CONE_DETECTOR_HPP
+
+#include "opendlv-standard-message-set.hpp"
+#include "perception-arrays.hpp"
+#include "task-graph.hpp"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Finds the blue, yellow and red cones in the lower half of a camera frame
+// and reduces them to the near and far aim points of the track. The detector
+// keeps the state between frames (last near point, last Kiwi bounding box),
+// so it can be driven both by the standalone service and by the combined
+// binary.
+//
+// A frame goes through a graph of stages: each colour is thresholded,
+// cleaned up and reduced to contours on its own, the red cones are found
+// first as the crossing limits where blue and yellow cones are taken, and
+// the blue and yellow tracks are then paired. With workers, the colours are
+// processed in parallel; the buffers of all stages are kept between frames.
+class ConeDetector {
+ private:
+  ConeDetector(ConeDetector const &) = delete;
+  ConeDetector(ConeDetector &&) = delete;
+  ConeDetector &operator=(ConeDetector const &) = delete;
+  ConeDetector &operator=(ConeDetector &&) = delete;
+
+ public:
+  // workers is the number of threads besides the caller's that run the
+  // stages of a frame.
+  ConeDetector(uint32_t width, uint32_t height, uint32_t workers = 0)
+    : m_width{width}
+    , m_height{height}
+    , m_kiwiBoundingBoxMutex{}
+    , m_boxX{0}
+    , m_boxY{0}
+    , m_boxW{0}
+    , m_boxH{0}
+    , m_previousNearPoint(width/2-1, height/2-1)
+    , m_cones{}
+    , m_img{nullptr}
+    , m_hsv{nullptr}
+    , m_red{*this, ConeColour::Red}
+    , m_blue{*this, ConeColour::Blue}
+    , m_yellow{*this, ConeColour::Yellow}
+    , m_crossing{}
+    , m_nearFarPoints{}
+    , m_stages{workers}
+  {
+    size_t const prepare{m_stages.add("prepare", &TaskGraph::invoke<ConeDetector, &ConeDetector::prepare>, this)};
+    size_t redTrack{0};
+    std::vector<size_t> tracks;
+    for (ColourChain *chain : {&m_red, &m_blue, &m_yellow}) {
+      std::string const colour{colourName(chain->colour)};
+      size_t const mask{m_stages.add(colour + "_mask", &TaskGraph::invoke<ColourChain, &ColourChain::threshold>, chain,
+            {prepare})};
+      size_t const morphology{m_stages.add(colour + "_morphology", &TaskGraph::invoke<ColourChain, &ColourChain::morphology>,
+            chain, {mask})};
+      size_t const contours{m_stages.add(colour + "_contours", &TaskGraph::invoke<ColourChain, &ColourChain::findContours>,
+            chain, {morphology})};
+      if (chain == &m_red) {
+        redTrack = m_stages.add("red_track", &TaskGraph::invoke<ConeDetector, &ConeDetector::findCrossing>, this, {contours});
+      } else {
+        tracks.push_back(m_stages.add(colour + "_track", &TaskGraph::invoke<ColourChain, &ColourChain::selectCones>, chain,
+              {contours, redTrack}));
+      }
+    }
+    m_stages.add("pairing", &TaskGraph::invoke<ConeDetector, &ConeDetector::pairTracks>, this, tracks);
+  }
+
+  // The part of the full frame that process() expects.
+  cv::Rect regionOfInterest() const noexcept {
+    return cv::Rect(0, m_height/2-1, m_width, m_height/2);
+  }
+
+  // The cones accepted in the last processed frame, in frame pixels.
+  std::vector<PackedCone> const &cones() const noexcept {
+    return m_cones;
+  }
+
+  // The stages with their times in the last processed frame.
+  TaskGraph const &stages() const noexcept {
+    return m_stages;
+  }
+
+  // Kiwi cars are masked out, as they carry blue and yellow parts.
+  void kiwiBoundingBox(uint32_t x, uint32_t y, uint32_t w, uint32_t h) noexcept {
+    std::lock_guard<std::mutex> lock(m_kiwiBoundingBoxMutex);
+    m_boxX = x;
+    m_boxY = y;
+    m_boxW = w;
+    m_boxH = h;
+  }
+
+  // Processes the region of interest of one frame (BGRA). The detections are
+  // drawn into img.
+  opendlv::perception::cognition::NearFarPoints process(cv::Mat &img) {
+    cv::Mat hsv;
+    cv::cvtColor(img, hsv, cv::COLOR_BGR2HSV);
+    return process(img, hsv);
+  }
+
+  // As above, but with the HSV conversion of the region of interest already
+  // done (for example by the preprocessing service). The uninteresting parts
+  // of hsv are blacked out in place.
+  opendlv::perception::cognition::NearFarPoints process(cv::Mat &img, cv::Mat &hsv) {
+    m_img = &img;
+    m_hsv = &hsv;
+    m_stages.run();
+    return m_nearFarPoints;
+  }
+
+ private:
+  static char const *colourName(ConeColour colour) noexcept {
+    switch (colour) {
+      case ConeColour::Blue: return "blue";
+      case ConeColour::Yellow: return "yellow";
+      default: return "red";
+    }
+  }
+
+  // One colour from the HSV frame to the centres of its cones, bottom first.
+  // Only the stages of this colour touch it.
+  struct ColourChain {
+    ColourChain(ConeDetector const &detector_, ConeColour colour_)
+      : detector(detector_)
+      , colour{colour_}
+      , low{}
+      , high{}
+      , mask{}
+      , dilated{}
+      , eroded{}
+      , edges{}
+      , contours{}
+      , hierarchy{}
+      , approxContours{}
+      , track{}
+      , boxes{}
+      , cones{}
+    {
+    }
+
+    void threshold() {
+      cv::inRange(*detector.m_hsv, low, high, mask);
+    }
+
+    void morphology() {
+      uint32_t iterations{4};
+      cv::dilate(mask, dilated, cv::Mat(), cv::Point(-1, -1), iterations, 1, 1);
+      cv::erode(dilated, eroded, cv::Mat(), cv::Point(-1, -1), iterations, 1, 1);
+    }
+
+    void findContours() {
+      cv::Canny(eroded, edges, 30, 90, 3);
+      contours.clear();
+      cv::findContours(edges, contours, hierarchy, CV_RETR_TREE, CV_CHAIN_APPROX_SIMPLE, cv::Point(0,0));
+      approxContours.resize(contours.size());
+      for (size_t k = 0; k < contours.size(); k++)
+      {
+        cv::approxPolyDP(cv::Mat(contours[k]), approxContours[k], 3, true);
+      }
+    }
+
+    // Keeps the contours that are shaped like a cone and lie where a cone of
+    // this colour can be; blue and yellow cones are only taken below the
+    // crossing. The boxes are drawn later, as the tracks run in parallel.
+    void selectCones() {
+      uint32_t const WIDTH{detector.m_width};
+      uint32_t const HEIGHT{detector.m_height};
+      uint32_t const maxYRed{detector.m_crossing.maxYRed};
+      int32_t const roiY{detector.regionOfInterest().y};
+      boxes.clear();
+      cones.clear();
+
+      int bubbleSortCounter;
+      size_t  hIndex = 0;
+      cv::Point swap;
+      int overlapTolerance = 25;
+      std::vector<std::vector<cv::Point>> hull(approxContours.size());
+      track.assign(40, cv::Point());
+      for (size_t i = 0; i < approxContours.size(); i++)
+      {
+        size_t nPoints = approxContours[i].size();
+        if (nPoints <= 30 && nPoints >= 3) {
+          cv::convexHull(cv::Mat(approxContours[i]), hull[hIndex], false);
+          cv::Point leftMostPoint(WIDTH,0);
+          cv::Point rightMostPoint(0,0);
+          cv::Point topPoint(0,HEIGHT);
+          cv::Point bottomPoint(0,0);
+          for (size_t j = 0; j < hull[hIndex].size(); j++)
+          {
+            cv::Point point = hull[hIndex][j];
+            if (point.x < leftMostPoint.x) {
+              leftMostPoint =  point;
+            }
+            if (point.x > rightMostPoint.x) {
+              rightMostPoint =  point;
+            }
+            if (point.y < topPoint.y) {
+              topPoint =  point;
+            }
+            if (point.y > bottomPoint.y) {
+              bottomPoint =  point;
+            }
+          }
+          float height = bottomPoint.y - topPoint.y;
+          float width = rightMostPoint.x  - leftMostPoint.x;
+          float yMid = (bottomPoint.y + topPoint.y)/2;
+          float xMid = (rightMostPoint.x  + leftMostPoint.x)/2;
+          float area = width*height;
+
+          //Find the right object based on shape and calculate the center of mass.
+          bool isConeShaped{width/height < 0.8 && width/height > 0.15};
+          bool isInPlace{area > 200 && area < WIDTH*HEIGHT/20};
+          switch (colour) {
+            case ConeColour::Red:
+              isInPlace = isInPlace && rightMostPoint.y> yMid && leftMostPoint.y> yMid;
+              break;
+            case ConeColour::Blue:
+              isConeShaped = width/height < 0.8  &&  width/height >= 0.15;
+              isInPlace = isInPlace && (yMid< HEIGHT/4 || xMid > WIDTH/2) && yMid > maxYRed;
+              break;
+            case ConeColour::Yellow:
+              isInPlace = isInPlace && (yMid< HEIGHT/4 || xMid < WIDTH/2) && yMid > maxYRed;
+              break;
+          }
+          if (isConeShaped && isInPlace) {
+            track[hIndex].x = static_cast<int> (std::round(xMid));
+            track[hIndex].y = static_cast<int> (std::round(yMid));
+            cones.push_back(PackedCone{track[hIndex].x, track[hIndex].y + roiY, colour});
+            boxes.push_back(cv::boundingRect(hull[hIndex]));
+            ++hIndex;
+          } else {
+            hull.erase(hull.begin() + hIndex);
+          }
+        } else {
+          hull.pop_back();
+        }
+      }
+      // Now we obtain all the center of mass in the track. The next step is to remove the overlapped points.
+      track.erase(track.begin() + hull.size(),track.begin() + track.size()-1);
+
+      for (size_t index = 0; index < track.size(); index ++)
+      {
+        if (abs(track[index].x - track[index+1].x) < overlapTolerance &&
+            abs(track[index].y - track[index+1].y) < overlapTolerance) {
+          track.erase(track.begin() + index + 1);
+        }
+      }
+
+      bool bubbleSortComplete = false;
+      if (track.size() > 1) {
+        while (!bubbleSortComplete) {
+          bubbleSortCounter = 0;
+          for (size_t index = 0; index < track.size() - 1; index ++)
+          {
+            if (track[index].y < track[index+1].y ) {
+              swap = track[index];
+              track[index] = track[index + 1];
+              track[index + 1] = swap;
+              bubbleSortCounter = bubbleSortCounter + 1;
+            }
+          }
+          if (bubbleSortCounter == 0) {
+            bubbleSortComplete = true;
+            break;
+          }
+        }
+      }
+    }
+
+    // Draws the accepted boxes and the track between them.
+    void draw(cv::Mat &img, cv::Scalar const &boxColour) const {
+      for (auto const &box : boxes) {
+        cv::rectangle(img, box.tl(), box.br(), boxColour, 2);
+      }
+      for (size_t index = 0; index < track.size(); index ++)
+      {
+        if (index < track.size() - 1) {
+          cv::line(img, track[index], track[index +1], cv::Scalar(0, 255, 0), 2, cv::LINE_AA);
+        }
+      }
+    }
+
+    ConeDetector const &detector;
+    ConeColour const colour;
+    cv::Scalar low;
+    cv::Scalar high;
+    cv::Mat mask;
+    cv::Mat dilated;
+    cv::Mat eroded;
+    cv::Mat edges;
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<cv::Vec4i> hierarchy;
+    std::vector<std::vector<cv::Point>> approxContours;
+    std::vector<cv::Point> track;
+    std::vector<cv::Rect> boxes;
+    std::vector<PackedCone> cones;
+  };
+
+  // What the red cones tell about a crossing ahead.
+  struct Crossing {
+    uint32_t maxYRed{0};
+    bool isReached{false};
+    bool isMatched{false};
+    cv::Point mean{};
+  };
+
+  // Blacks out what is not of interest and sets the thresholds of the
+  // colours for this frame.
+  void prepare() {
+    uint32_t const WIDTH{m_width};
+    uint32_t const HEIGHT{m_height};
+    cv::Mat &img{*m_img};
+    cv::Mat &hsv{*m_hsv};
+
+    cv::line(img, cv::Point(0,39), cv::Point(WIDTH-1,39), cv::Scalar(255, 255, 0), 2, cv::LINE_AA);
+
+    // calculate the mean value.
+    cv::Scalar meanHSVLeft =cv::mean(hsv(cv::Rect(0,0,WIDTH/2, HEIGHT/2)));
+    cv::Scalar meanHSVRight =cv::mean(hsv(cv::Rect(WIDTH/2-1,0,WIDTH/2, HEIGHT/2)));
+    //seting uninterested region to black 
+    hsv(cv::Rect(WIDTH/4-1,3*HEIGHT/8-1,WIDTH/2, HEIGHT/8)) = cv::Scalar(0,0,0);
+    hsv(cv::Rect(0,0,WIDTH, 40)) = cv::Scalar(0,0,0);
+
+    {
+      // The bounding box is updated from the OD4 receive thread.
+      std::lock_guard<std::mutex> lock(m_kiwiBoundingBoxMutex);
+      int32_t NewboxY = static_cast<int32_t>(m_boxY) - static_cast<int32_t>(HEIGHT/2);
+      int32_t NewboxH = NewboxY + static_cast<int32_t>(m_boxH);
+      if (NewboxY < 0) {
+        m_boxY = 0;
+      } else {
+        m_boxY = static_cast<uint32_t> (NewboxY);
+      }
+      if (NewboxH < 0) {
+        m_boxH = 0;
+      } else {
+         m_boxH = static_cast<uint32_t> (NewboxH);
+      }
+      hsv(cv::Rect(static_cast<uint32_t>(m_boxX+0.25*m_boxW),m_boxY,static_cast<uint32_t>(0.5*m_boxW), 
+          static_cast<uint32_t>(0.7*m_boxH)))= cv::Scalar(0,0,0);
+    }
+
+    m_blue.low = cv::Scalar(110, static_cast<uint32_t>(101+ 1.0*(meanHSVRight[1] - 45)), 20);
+    m_blue.high = cv::Scalar(130, 255, 150);
+
+    m_yellow.low = cv::Scalar(10, static_cast<uint32_t>(70+ 1.0*(meanHSVLeft[1] - 45)), 100);
+    m_yellow.high = cv::Scalar(40, 255, 255);
+
+    m_red.low = cv::Scalar(156,120, 70);
+    m_red.high = cv::Scalar(180, 255, 255);
+  }
+
+  // The red cones are found before the others, and two of them on either
+  // side of the middle mark the crossing.
+  void findCrossing() {
+    uint32_t const WIDTH{m_width};
+    cv::Mat &img{*m_img};
+    m_red.selectCones();
+    for (auto const &box : m_red.boxes) {
+      cv::rectangle(img, box.tl(), box.br(), cv::Scalar(0,0,255), 2);
+    }
+    std::vector<cv::Point> const &redTrack{m_red.track};
+
+    uint32_t meanX = 0;
+    uint32_t meanY = 0;
+    int32_t paramThreshold = - static_cast<int32_t>(WIDTH/6*WIDTH/6);
+    bool findRedConeMatch = false;
+
+    for (size_t index = 0; index < redTrack.size(); index ++)
+    { 
+      if (index < redTrack.size() - 1) {  
+        int32_t param = (static_cast<int32_t>(redTrack[index].x) - static_cast<int32_t>(WIDTH/2-1)) * 
+                        (static_cast<int32_t>(redTrack[index + 1].x) - static_cast<int32_t>(WIDTH/2-1));  
+        int32_t  yDistance = abs(static_cast<int32_t>(redTrack[index].y) - static_cast<int32_t>(redTrack[index + 1].y));
+        if (param < paramThreshold && yDistance <= 70 )  {
+            cv::line(img, redTrack[index], redTrack[index +1], cv::Scalar(255, 255, 255), 2, cv::LINE_AA); 
+            meanX = (redTrack[index].x + redTrack[index+1].x)/2;
+            meanY = (redTrack[index].y + redTrack[index+1].y)/2;
+            findRedConeMatch = true;
+            cv::circle(img, cv::Point(meanX,meanY), 3, cv::Scalar(0, 0, 255), cv::FILLED, cv::LINE_AA); 
+            break;  
+        }              
+      }
+    }
+
+    m_crossing.maxYRed = redTrack[0].y;
+    m_crossing.isReached = redTrack.size() > 1;
+    m_crossing.isMatched = findRedConeMatch;
+    m_crossing.mean = cv::Point(meanX, meanY);
+  }
+
+  // Pairs the blue and yellow cones into the points of the track, and picks
+  // the near and far aim points.
+  void pairTracks() {
+    uint32_t const WIDTH{m_width};
+    uint32_t const HEIGHT{m_height};
+    cv::Mat &img{*m_img};
+    m_blue.draw(img, cv::Scalar(255,0,0));
+    m_yellow.draw(img, cv::Scalar(0,255,255));
+    m_cones.clear();
+    for (ColourChain const *chain : {&m_red, &m_blue, &m_yellow}) {
+      m_cones.insert(m_cones.end(), chain->cones.begin(), chain->cones.end());
+    }
+    std::vector<cv::Point> &blueTrack{m_blue.track};
+    std::vector<cv::Point> &yellowTrack{m_yellow.track};
+
+    size_t size = std::max(yellowTrack.size() , blueTrack.size());
+    size_t nPair = std::min(yellowTrack.size(), blueTrack.size());
+    std::vector<cv::Point> realTrack(size);
+
+    if (nPair == 0 && yellowTrack.size() > blueTrack.size()) {
+      cv::Point blue(WIDTH-51,HEIGHT/2-51);
+      blueTrack.push_back(blue);
+      nPair = 1;
+    } else if (nPair == 0 && blueTrack.size() > yellowTrack.size())  {
+      cv::Point yellow(50,HEIGHT/2-51);
+      yellowTrack.push_back(yellow);
+      nPair = 1;
+    }
+
+    for (size_t index = 0; index < size; index ++)
+    {                   
+       if (index < nPair) {
+         realTrack[index].x = (blueTrack[index].x + yellowTrack[index].x)/2;               
+         realTrack[index].y = (blueTrack[index].y + yellowTrack[index].y)/2;  
+         cv::line(img, yellowTrack[index] , blueTrack[index] , cv::Scalar(255, 255, 255), 4, cv::LINE_AA);   
+         cv::circle(img, realTrack[index], 5, cv::Scalar(0, 0, 255), cv::FILLED, cv::LINE_AA); 
+       } else if (yellowTrack.size() > blueTrack.size() && yellowTrack.size() > 1 ) {
+         if (index < yellowTrack.size()  && nPair != 0) {
+             realTrack[index].x = (blueTrack[blueTrack.size()-1].x + yellowTrack[index].x)/2;               
+             realTrack[index].y = (blueTrack[blueTrack.size()-1].y + yellowTrack[index].y)/2;
+             cv::line(img, yellowTrack[index] , blueTrack[blueTrack.size()-1] , cv::Scalar(255, 255, 255), 4, cv::LINE_AA);
+             cv::circle(img, realTrack[index], 5, cv::Scalar(0, 0, 255), cv::FILLED, cv::LINE_AA);     
+         }
+       } else if (blueTrack.size() > 1 && index < blueTrack.size()) {
+         if (index < blueTrack.size() && nPair != 0) {
+            realTrack[index].x = (blueTrack[index].x + yellowTrack[yellowTrack.size()-1].x)/2;               
+            realTrack[index].y = (blueTrack[index].y + yellowTrack[yellowTrack.size()-1].y)/2;
+            cv::line(img, yellowTrack[yellowTrack.size()-1] , blueTrack[index] , cv::Scalar(255, 255, 255), 4, cv::LINE_AA);
+            cv::circle(img, realTrack[index], 5, cv::Scalar(0, 0, 255), cv::FILLED, cv::LINE_AA);       
+         }
+       }  
+    }
+
+    if (m_crossing.isMatched) {
+       realTrack.push_back(m_crossing.mean);
+    }
+
+    if (realTrack.size() > 0) {
+      float horizontalMovement = static_cast<float>(fabs(static_cast<double>(m_previousNearPoint.x) - static_cast<double>(realTrack[0].x)));
+      if (horizontalMovement > static_cast<float> (WIDTH/25)) { 
+        uint32_t newX = (realTrack[0].x + m_previousNearPoint.x)/2;
+        uint32_t newY = (realTrack[0].y + m_previousNearPoint.y)/2;
+        realTrack[0].x = newX;
+        realTrack[0].y = newY;
+        cv::circle(img, realTrack[0], 5, cv::Scalar(0, 255, 255), cv::FILLED, cv::LINE_AA);  
+      }
+      m_previousNearPoint = realTrack[0];
+    }
+
+    int nx;
+    int ny;
+    int fx;
+    int fy;
+    if  (realTrack.size() != 0) { 
+      cv::Point nearPoint = realTrack[0];
+      cv::Point farPoint = realTrack[realTrack.size()-1];
+      ny = -(nearPoint.x-WIDTH/2+1);
+      nx = (HEIGHT/2-1-nearPoint.y);
+      fy = -(farPoint.x - WIDTH/2+1);
+      fx = (HEIGHT/2-1-farPoint.y);       
+      if (realTrack.size() > 1) {
+        fy = ny;
+        fx = nx;
+      }          
+    } else { 
+      nx = 0;
+      ny = 0;
+      fx = 0;
+      fy = 0;
+    }
+
+    opendlv::perception::cognition::NearFarPoints &nfPoints{m_nearFarPoints};
+    nfPoints.nearX(nx);
+    nfPoints.nearY(ny);
+    nfPoints.farX(fx);
+    nfPoints.farY(fy);
+    nfPoints.reachCrossRoad(m_crossing.isReached);
+  }
+
+  uint32_t const m_width;
+  uint32_t const m_height;
+  std::mutex m_kiwiBoundingBoxMutex;
+  uint32_t m_boxX;
+  uint32_t m_boxY;
+  uint32_t m_boxW;
+  uint32_t m_boxH;
+  cv::Point m_previousNearPoint;
+  std::vector<PackedCone> m_cones;
+  cv::Mat *m_img;
+  cv::Mat *m_hsv;
+  ColourChain m_red;
+  ColourChain m_blue;
+  ColourChain m_yellow;
+  Crossing m_crossing;
+  opendlv::perception::cognition::NearFarPoints m_nearFarPoints;
+  TaskGraph m_stages;
+};
+
+// The aim points and all cones of a frame in one message. sampleTime is that
+// of the frame, in microseconds.
+inline opendlv::perception::ConeArray toConeArray(opendlv::perception::cognition::NearFarPoints const &nfPoints,
+    std::vector<PackedCone> const &cones, uint32_t frameId, int64_t sampleTime, uint32_t imageWidth, uint32_t imageHeight) {
+  std::string packed;
+  packCones(cones, packed);
+  opendlv::perception::ConeArray coneArray;
+  coneArray.frameId(frameId);
+  coneArray.sampleTime(sampleTime);
+  coneArray.imageWidth(imageWidth);
+  coneArray.imageHeight(imageHeight);
+  coneArray.nearX(nfPoints.nearX());
+  coneArray.nearY(nfPoints.nearY());
+  coneArray.farX(nfPoints.farX());
+  coneArray.farY(nfPoints.farY());
+  coneArray.reachCrossRoad(nfPoints.reachCrossRoad());
+  coneArray.nCone(static_cast<uint32_t>(cones.size()));
+  coneArray.cones(packed);
+  return coneArray;
+}
+
+#endif
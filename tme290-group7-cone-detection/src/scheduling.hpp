@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCHEDULING_HPP
+#define SCHEDULING_HPP
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Where and how a service runs on a host that it shares with the others.
+//   cpus:     the cores of the service, e.g. "2-3" or "0,2" (all if empty)
+//   threads:  worker threads of OpenCV and the network (its default if 0)
+//   priority: SCHED_FIFO priority (1 to 99) of the time-critical thread,
+//             normal scheduling if 0
+struct Scheduling {
+  std::string cpus{};
+  int32_t threads{0};
+  int32_t priority{0};
+};
+
+// The settings of a service from --scheduling-config=<file>, a file shared
+// by all services with lines such as "logic-control.cpus=3", then overridden
+// by --cpus, --threads and --rt-priority. Lines starting with # are
+// comments.
+inline Scheduling schedulingFrom(std::string const &service, std::map<std::string, std::string> &commandlineArguments) {
+  std::map<std::string, std::string> values;
+  if (commandlineArguments.count("scheduling-config") != 0) {
+    std::ifstream file(commandlineArguments["scheduling-config"]);
+    if (!file.good()) {
+      std::cerr << "Could not read " << commandlineArguments["scheduling-config"] << "." << std::endl;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+      size_t const separator{line.find('=')};
+      if (line.empty() || line[0] == '#' || separator == std::string::npos
+          || line.compare(0, service.size() + 1, service + ".") != 0) {
+        continue;
+      }
+      std::stringstream key(line.substr(service.size() + 1, separator - service.size() - 1));
+      std::stringstream value(line.substr(separator + 1));
+      std::string k;
+      std::string v;
+      key >> k;
+      value >> v;
+      values[k] = v;
+    }
+  }
+  for (auto const &key : {"cpus", "threads", "rt-priority"}) {
+    if (commandlineArguments.count(key) != 0) {
+      values[key] = commandlineArguments[key];
+    }
+  }
+
+  Scheduling scheduling;
+  scheduling.cpus = values["cpus"];
+  scheduling.threads = values["threads"].empty() ? 0 : std::stoi(values["threads"]);
+  scheduling.priority = values["rt-priority"].empty() ? 0 : std::stoi(values["rt-priority"]);
+  return scheduling;
+}
+
+// "0-1,3" as {0, 1, 3}.
+inline std::vector<int32_t> cpuList(std::string const &cpus) {
+  std::vector<int32_t> list;
+  std::stringstream sstr(cpus);
+  std::string range;
+  while (std::getline(sstr, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    size_t const dash{range.find('-')};
+    int32_t const first{std::stoi(range.substr(0, dash))};
+    int32_t const last{(dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1))};
+    for (int32_t cpu = first; cpu <= last; cpu++) {
+      list.push_back(cpu);
+    }
+  }
+  return list;
+}
+
+// Restricts the calling thread, and the threads it creates afterwards, to
+// the given cores. Does nothing for an empty list.
+inline bool pinThread(std::string const &cpus) {
+  std::vector<int32_t> const list{cpuList(cpus)};
+  if (list.empty()) {
+    return true;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int32_t cpu : list) {
+    CPU_SET(cpu, &set);
+  }
+  int32_t const result{pthread_setaffinity_np(pthread_self(), sizeof(set), &set)};
+  if (0 != result) {
+    std::cerr << "Could not run on cores " << cpus << ": " << std::strerror(result) << std::endl;
+  }
+  return (0 == result);
+}
+
+// Runs the calling thread with SCHED_FIFO at the given priority, so that it
+// preempts all normally scheduled threads of the host when it wakes up.
+// Needs CAP_SYS_NICE (in Docker: cap_add SYS_NICE and an rtprio ulimit).
+// Does nothing for priority 0.
+inline bool setRealtimePriority(int32_t priority) {
+  if (priority <= 0) {
+    return true;
+  }
+  struct sched_param parameters{};
+  parameters.sched_priority = priority;
+  int32_t const result{pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters)};
+  if (0 != result) {
+    std::cerr << "Could not use SCHED_FIFO priority " << priority << ": " << std::strerror(result) << std::endl;
+  }
+  return (0 == result);
+}
+
+#endif
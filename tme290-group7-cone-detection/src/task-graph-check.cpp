@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "task-graph.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static uint32_t failures{0};
+
+static void expect(bool isTrue, std::string const &what) {
+  if (!isTrue) {
+    std::cerr << "Failed: " << what << std::endl;
+    failures++;
+  }
+}
+
+// The graph of the cone detection: a preparation, three chains of three
+// stages, the tracks of which depend on red, and a pairing at the end. Each
+// task notes when it started and ended on a shared clock.
+class Stages {
+ private:
+  Stages(Stages const &) = delete;
+  Stages(Stages &&) = delete;
+  Stages &operator=(Stages const &) = delete;
+  Stages &operator=(Stages &&) = delete;
+
+  struct Stage {
+    Stages *stages;
+    size_t index;
+    uint64_t start;
+    uint64_t end;
+    bool hasRun;
+
+    void run() {
+      start = stages->m_clock++;
+      hasRun = true;
+      if (index == stages->m_throwing) {
+        throw std::runtime_error{"stage " + std::to_string(index)};
+      }
+      end = stages->m_clock++;
+    }
+  };
+
+ public:
+  explicit Stages(uint32_t workers)
+    : m_graph{workers}
+    , m_stages{}
+    , m_dependencies{}
+    , m_clock{0}
+    , m_throwing{SIZE_MAX}
+  {
+    // The tasks point into m_stages, so it must not grow past this.
+    m_stages.reserve(14);
+    size_t const prepare{add({})};
+    std::vector<size_t> tracks;
+    for (size_t colour = 0; colour < 3; colour++) {
+      size_t const mask{add({prepare})};
+      size_t const morphology{add({mask})};
+      size_t const contours{add({morphology})};
+      tracks.push_back(contours);
+    }
+    size_t const redTrack{add({tracks[0]})};
+    size_t const blueTrack{add({tracks[1], redTrack})};
+    size_t const yellowTrack{add({tracks[2], redTrack})};
+    add({blueTrack, yellowTrack});
+  }
+
+  // Runs the graph with the given task throwing (SIZE_MAX for none). Gives
+  // the message of the exception that run() threw, or "" if none.
+  std::string run(size_t throwing) {
+    m_throwing = throwing;
+    for (auto &stage : m_stages) {
+      stage.start = 0;
+      stage.end = 0;
+      stage.hasRun = false;
+    }
+    try {
+      m_graph.run();
+    } catch (std::exception const &e) {
+      return e.what();
+    }
+    return "";
+  }
+
+  size_t size() const noexcept {
+    return m_stages.size();
+  }
+
+  std::vector<size_t> const &dependencies(size_t task) const noexcept {
+    return m_dependencies[task];
+  }
+
+  Stage const &stage(size_t task) const noexcept {
+    return m_stages[task];
+  }
+
+  TaskGraph const &graph() const noexcept {
+    return m_graph;
+  }
+
+ private:
+  size_t add(std::vector<size_t> const &dependencies) {
+    size_t const index{m_stages.size()};
+    m_stages.push_back(Stage{this, index, 0, 0, false});
+    m_dependencies.push_back(dependencies);
+    return m_graph.add("stage" + std::to_string(index), TaskGraph::invoke<Stage, &Stage::run>,
+        &m_stages.back(), dependencies);
+  }
+
+  TaskGraph m_graph;
+  std::vector<Stage> m_stages;
+  std::vector<std::vector<size_t>> m_dependencies;
+  std::atomic<uint64_t> m_clock;
+  size_t m_throwing;
+};
+
+// Whether the task depends on the other one, directly or not.
+static bool dependsOn(Stages const &stages, size_t task, size_t other) {
+  for (size_t dependency : stages.dependencies(task)) {
+    if (dependency == other || dependsOn(stages, dependency, other)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void checkRuns(uint32_t workers, uint32_t runs) {
+  std::string const WITH{" with " + std::to_string(workers) + " worker(s)"};
+  Stages stages{workers};
+  expect(stages.graph().size() == stages.size(), "the graph has every task" + WITH);
+  expect(stages.graph().name(3) == "stage3", "a task keeps its name" + WITH);
+
+  for (uint32_t run = 0; run < runs; run++) {
+    expect(stages.run(SIZE_MAX).empty(), "a run without errors does not throw" + WITH);
+    for (size_t task = 0; task < stages.size(); task++) {
+      expect(stages.stage(task).hasRun, "every task runs once per run" + WITH);
+      for (size_t dependency : stages.dependencies(task)) {
+        expect(stages.stage(dependency).end < stages.stage(task).start,
+            "stage" + std::to_string(task) + " starts after stage" + std::to_string(dependency) + " ended" + WITH);
+      }
+      expect(stages.graph().time(task) >= 0.0, "a task has a time" + WITH);
+    }
+    if (workers == 0) {
+      // Alone, the calling thread runs the tasks in the order they were added.
+      for (size_t task = 1; task < stages.size(); task++) {
+        expect(stages.stage(task - 1).end < stages.stage(task).start, "without workers, the tasks run in order");
+      }
+    }
+  }
+
+  // A throwing task: its exception comes out of run(), and the tasks that
+  // depend on it do not run. The graph runs normally afterwards.
+  for (size_t throwing = 0; throwing < stages.size(); throwing++) {
+    std::string const error{stages.run(throwing)};
+    expect(error == "stage " + std::to_string(throwing),
+        "the exception of stage" + std::to_string(throwing) + " is thrown by run()" + WITH);
+    for (size_t task = 0; task < stages.size(); task++) {
+      if (dependsOn(stages, task, throwing)) {
+        expect(!stages.stage(task).hasRun,
+            "stage" + std::to_string(task) + " is skipped after stage" + std::to_string(throwing) + " threw" + WITH);
+      }
+      if (dependsOn(stages, throwing, task)) {
+        expect(stages.stage(task).hasRun, "stage" + std::to_string(task) + " ran before stage" + std::to_string(throwing) + WITH);
+      }
+    }
+    expect(stages.run(SIZE_MAX).empty(), "a run after an exception does not throw" + WITH);
+    bool hasAllRun{true};
+    for (size_t task = 0; task < stages.size(); task++) {
+      hasAllRun = hasAllRun && stages.stage(task).hasRun;
+    }
+    expect(hasAllRun, "every task runs again after an exception" + WITH);
+  }
+}
+
+// Runs the graph of the cone detection with no and with several workers,
+// checks the order of the tasks against their dependencies, and has each
+// task throw once. Exits with 1 if any check fails.
+int32_t main(int32_t argc, char **argv) {
+  uint32_t const RUNS{(argc > 1) ? static_cast<uint32_t>(std::stoi(argv[1])) : 1000};
+  for (uint32_t workers : {0u, 1u, 2u, 4u}) {
+    checkRuns(workers, RUNS);
+  }
+  if (failures > 0) {
+    std::cerr << failures << " check(s) failed." << std::endl;
+    return 1;
+  }
+  std::cout << "All task graph checks passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TASK_GRAPH_HPP
+#define TASK_GRAPH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A fixed graph of tasks that is run once per frame. The tasks are added
+// once, as plain function pointers with a context, so a run allocates
+// nothing. A task starts when all tasks it depends on are done; of the ready
+// tasks, the one added first runs first. The calling thread works on the
+// graph together with a fixed pool of workers, so with no workers, the tasks
+// simply run in the order they were added.
+class TaskGraph {
+ private:
+  TaskGraph(TaskGraph const &) = delete;
+  TaskGraph(TaskGraph &&) = delete;
+  TaskGraph &operator=(TaskGraph const &) = delete;
+  TaskGraph &operator=(TaskGraph &&) = delete;
+
+ public:
+  using Function = void (*)(void *context);
+
+  // A Function that calls Method on the context.
+  template <typename T, void (T::*Method)()>
+  static void invoke(void *context) {
+    (static_cast<T *>(context)->*Method)();
+  }
+
+  explicit TaskGraph(uint32_t workers)
+    : m_tasks{}
+    , m_mutex{}
+    , m_changed{}
+    , m_ready{}
+    , m_pending{}
+    , m_remaining{0}
+    , m_error{}
+    , m_isStopping{false}
+    , m_workers{}
+  {
+    for (uint32_t i = 0; i < workers; i++) {
+      m_workers.emplace_back([this]() { work(); });
+    }
+  }
+
+  ~TaskGraph() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_isStopping = true;
+    }
+    m_changed.notify_all();
+    for (auto &worker : m_workers) {
+      worker.join();
+    }
+  }
+
+  // Adds a task that runs after the given ones, and gives its index. All
+  // tasks are added before the first run().
+  size_t add(std::string const &name, Function function, void *context,
+      std::vector<size_t> const &dependencies = std::vector<size_t>{}) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t const index{m_tasks.size()};
+    m_tasks.push_back(Task{name, function, context, {}, static_cast<uint32_t>(dependencies.size()), 0.0});
+    for (size_t dependency : dependencies) {
+      m_tasks[dependency].dependents.push_back(index);
+    }
+    m_ready.reserve(m_tasks.size());
+    m_pending.resize(m_tasks.size());
+    return index;
+  }
+
+  // Runs every task once and returns when all are done. If a task throws,
+  // the tasks that have not started yet are skipped and the exception is
+  // thrown here.
+  void run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < m_tasks.size(); i++) {
+      m_pending[i] = m_tasks[i].dependencies;
+      if (m_pending[i] == 0) {
+        m_ready.push_back(i);
+      }
+    }
+    m_remaining = m_tasks.size();
+    m_error = nullptr;
+    m_changed.notify_all();
+    while (m_remaining > 0) {
+      if (m_ready.empty()) {
+        m_changed.wait(lock);
+      } else {
+        runNext(lock);
+      }
+    }
+    if (m_error) {
+      std::rethrow_exception(m_error);
+    }
+  }
+
+  size_t size() const noexcept {
+    return m_tasks.size();
+  }
+
+  std::string const &name(size_t task) const noexcept {
+    return m_tasks[task].name;
+  }
+
+  // How long the task took in the last run, in ms.
+  double time(size_t task) const noexcept {
+    return m_tasks[task].time;
+  }
+
+ private:
+  struct Task {
+    std::string name;
+    Function function;
+    void *context;
+    std::vector<size_t> dependents;
+    uint32_t dependencies;
+    double time;
+  };
+
+  void work() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+      m_changed.wait(lock, [this]() { return m_isStopping || !m_ready.empty(); });
+      if (m_isStopping) {
+        return;
+      }
+      runNext(lock);
+    }
+  }
+
+  // Takes the first ready task and runs it without the lock.
+  void runNext(std::unique_lock<std::mutex> &lock) {
+    auto const first{std::min_element(m_ready.begin(), m_ready.end())};
+    size_t const index{*first};
+    m_ready.erase(first);
+    Task &task{m_tasks[index]};
+    bool const isSkipped{static_cast<bool>(m_error)};
+    lock.unlock();
+
+    std::exception_ptr error;
+    auto const start{std::chrono::steady_clock::now()};
+    if (!isSkipped) {
+      try {
+        task.function(task.context);
+      } catch (...) {
+        error = std::current_exception();
+      }
+    }
+    double const time{std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()};
+
+    lock.lock();
+    task.time = time;
+    if (error && !m_error) {
+      m_error = error;
+    }
+    for (size_t dependent : task.dependents) {
+      if (--m_pending[dependent] == 0) {
+        m_ready.push_back(dependent);
+      }
+    }
+    m_remaining--;
+    m_changed.notify_all();
+  }
+
+  std::vector<Task> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_changed;
+  std::vector<size_t> m_ready;
+  std::vector<uint32_t> m_pending;
+  size_t m_remaining;
+  std::exception_ptr m_error;
+  bool m_isStopping;
+  std::vector<std::thread> m_workers;
+};
+
+#endif
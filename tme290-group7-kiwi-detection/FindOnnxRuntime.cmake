@@ -0,0 +1,47 @@
+# You may redistribute this program and/or modify it under the terms of
+# the GNU General Public License as published by the Free Software Foundation,
+# either version 3 of the License, or (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+if(NOT ONNXRUNTIME_FOUND)
+
+    find_path(ONNXRUNTIME_INCLUDE_DIR
+        NAMES
+            onnxruntime_cxx_api.h
+        PATHS
+            ${ONNXRUNTIMEDIR}/include/
+            /usr/local/include/
+            /usr/include/
+        PATH_SUFFIXES
+            onnxruntime
+            onnxruntime/core/session
+    )
+
+    find_library(
+        ONNXRUNTIME_LIBRARIES onnxruntime
+        PATHS
+            ${ONNXRUNTIMEDIR}/lib/
+            /usr/local/lib/
+            /usr/lib/
+    )
+
+    if (ONNXRUNTIME_INCLUDE_DIR AND ONNXRUNTIME_LIBRARIES)
+        set (ONNXRUNTIME_FOUND TRUE)
+    endif (ONNXRUNTIME_INCLUDE_DIR AND ONNXRUNTIME_LIBRARIES)
+
+    if (ONNXRUNTIME_FOUND)
+        message(STATUS "Found ONNX Runtime: ${ONNXRUNTIME_INCLUDE_DIR}, ${ONNXRUNTIME_LIBRARIES}")
+    else (ONNXRUNTIME_FOUND)
+        if (OnnxRuntime_FIND_REQUIRED)
+            message (FATAL_ERROR "Could not find ONNX Runtime, try to set ONNXRUNTIMEDIR accordingly")
+        endif (OnnxRuntime_FIND_REQUIRED)
+    endif (ONNXRUNTIME_FOUND)
+
+endif (NOT ONNXRUNTIME_FOUND)
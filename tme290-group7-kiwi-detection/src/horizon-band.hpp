@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HORIZON_BAND_HPP
+#define HORIZON_BAND_HPP
+
+#include <opencv2/core/core.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Focal length in pixels of a pinhole camera with a vertical field of view of
+// fovy (degrees).
+inline double focalLength(cv::Size const &frameSize, double fovy) {
+  double const pi{3.14159265358979323846};
+  return 0.5 * frameSize.height / std::tan(0.5 * fovy * pi / 180.0);
+}
+
+// The rows of the frame in which a Kiwi on the floor can appear, for a level
+// pinhole camera at height cameraZ (m) with a vertical field of view of
+// fovy (degrees). A Kiwi of height kiwiHeight (m) at distance d spans the
+// rows from f * (kiwiHeight - cameraZ) / d above the horizon to
+// f * cameraZ / d below it, so the band of the nearest distance covers all
+// farther ones. margin (rows) is added on both sides for pitch and bumps.
+inline cv::Rect horizonBand(cv::Size const &frameSize, double cameraZ, double fovy,
+    double kiwiHeight, double minDistance, int32_t margin) {
+  double const f{focalLength(frameSize, fovy)};
+  double const horizon{0.5 * frameSize.height};
+  double const above{f * std::max(kiwiHeight - cameraZ, 0.0) / minDistance};
+  double const below{f * cameraZ / minDistance};
+  int32_t const top{std::max(static_cast<int32_t>(std::floor(horizon - above)) - margin, 0)};
+  int32_t const bottom{std::min(static_cast<int32_t>(std::ceil(horizon + below)) + margin, frameSize.height)};
+  return cv::Rect(0, top, frameSize.width, std::max(bottom - top, 1));
+}
+
+// A network input of the given width for the band at its own aspect, with
+// the height rounded up to the multiple of 32 that YOLO needs (the rest is
+// letterboxed).
+inline cv::Size bandInputSize(cv::Rect const &band, int32_t inputWidth) {
+  double const height{static_cast<double>(inputWidth) * band.height / band.width};
+  return cv::Size(inputWidth, std::max(32, static_cast<int32_t>(std::ceil(height / 32.0)) * 32));
+}
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KIWI_CAMERAS_HPP
+#define KIWI_CAMERAS_HPP
+
+#include "cluon-complete.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The newest frame of one camera.
+struct CameraFrame {
+  size_t camera{0};
+  cluon::data::TimeStamp sampleTime{};
+  cv::Mat image{};
+};
+
+// Follows the shared memory areas of several cameras, one thread each, and
+// hands out the frames that arrive close together so that they can share one
+// batched forward pass. A camera that delivers a second frame before the
+// batch is taken only keeps its newest one.
+class CameraBatcher {
+ private:
+  CameraBatcher(CameraBatcher const &) = delete;
+  CameraBatcher(CameraBatcher &&) = delete;
+  CameraBatcher &operator=(CameraBatcher const &) = delete;
+  CameraBatcher &operator=(CameraBatcher &&) = delete;
+
+ public:
+  CameraBatcher(std::vector<std::string> const &names) noexcept
+    : m_sharedMemories{}
+    , m_mutex{}
+    , m_newFrame{}
+    , m_frames(names.size())
+    , m_isFresh(names.size(), false)
+    , m_isRunning{true}
+    , m_stoppedThreads{0}
+    , m_threads{}
+  {
+    for (auto const &name : names) {
+      m_sharedMemories.emplace_back(new cluon::SharedMemory{name});
+    }
+    for (size_t i = 0; i < names.size(); i++) {
+      m_frames[i].camera = i;
+    }
+  }
+
+  // A thread may have checked the flag just before waiting, so the cameras
+  // are woken until every thread has seen it.
+  ~CameraBatcher() {
+    m_isRunning.store(false);
+    while (m_stoppedThreads.load() < m_threads.size()) {
+      for (auto &sharedMemory : m_sharedMemories) {
+        sharedMemory->notifyAll();
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for (auto &thread : m_threads) {
+      thread.join();
+    }
+  }
+
+  bool valid() const noexcept {
+    bool isValid{true};
+    for (auto const &sharedMemory : m_sharedMemories) {
+      isValid &= (sharedMemory && sharedMemory->valid());
+    }
+    return isValid;
+  }
+
+  // Starts one thread per camera, reading images of the given size and
+  // OpenCV type. The threads block in the shared memory wait. Gives false,
+  // without starting any thread, if an area is too small for such an image.
+  bool start(cv::Size const &size, int32_t type) {
+    size_t const bytes{static_cast<size_t>(size.area()) * CV_ELEM_SIZE(type)};
+    for (auto const &sharedMemory : m_sharedMemories) {
+      if (sharedMemory->size() < bytes) {
+        return false;
+      }
+    }
+    for (size_t i = 0; i < m_sharedMemories.size(); i++) {
+      m_threads.emplace_back([this, i, size, type]() {
+          cluon::SharedMemory &sharedMemory = *m_sharedMemories[i];
+          while (m_isRunning.load()) {
+            sharedMemory.wait();
+            if (!m_isRunning.load()) {
+              break;
+            }
+
+            CameraFrame frame;
+            frame.camera = i;
+            sharedMemory.lock();
+            {
+              cv::Mat wrapped(size, type, sharedMemory.data());
+              frame.image = wrapped.clone();
+              frame.sampleTime = sharedMemory.getTimeStamp().second;
+            }
+            sharedMemory.unlock();
+
+            {
+              std::lock_guard<std::mutex> lock(m_mutex);
+              m_frames[i] = std::move(frame);
+              m_isFresh[i] = true;
+            }
+            m_newFrame.notify_one();
+          }
+          m_stoppedThreads++;
+        });
+    }
+    return true;
+  }
+
+  // Waits for a first new frame, then up to window for the other cameras,
+  // and returns the new frames (empty after a timeout without frames).
+  std::vector<CameraFrame> next(std::chrono::milliseconds const &window) {
+    std::vector<CameraFrame> frames;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto anyFresh = [this]() {
+        for (bool isFresh : m_isFresh) {
+          if (isFresh) {
+            return true;
+          }
+        }
+        return false;
+      };
+    auto allFresh = [this]() {
+        for (bool isFresh : m_isFresh) {
+          if (!isFresh) {
+            return false;
+          }
+        }
+        return true;
+      };
+    if (m_newFrame.wait_for(lock, std::chrono::milliseconds(100), anyFresh)) {
+      m_newFrame.wait_for(lock, window, allFresh);
+      for (size_t i = 0; i < m_frames.size(); i++) {
+        if (m_isFresh[i]) {
+          frames.push_back(std::move(m_frames[i]));
+          m_isFresh[i] = false;
+        }
+      }
+    }
+    return frames;
+  }
+
+ private:
+  std::vector<std::unique_ptr<cluon::SharedMemory>> m_sharedMemories;
+  std::mutex m_mutex;
+  std::condition_variable m_newFrame;
+  std::vector<CameraFrame> m_frames;
+  std::vector<bool> m_isFresh;
+  std::atomic<bool> m_isRunning;
+  std::atomic<size_t> m_stoppedThreads;
+  std::vector<std::thread> m_threads;
+};
+
+#endif
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2018  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KIWI_DETECTOR_HPP
+#define KIWI_DETECTOR_HPP
+
+#include "opendlv-standard-message-set.hpp"
+#include "perception-arrays.hpp"
+#include "yolo-backend.hpp"
+#include "yolo-decoder.hpp"
+
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/dnn/dnn.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Runs the YOLOv3-tiny Kiwi model on full camera frames (BGRA) and returns
+// the bounding boxes in frame pixels after non maximum suppression.
+class KiwiDetector {
+ private:
+  KiwiDetector(KiwiDetector const &) = delete;
+  KiwiDetector(KiwiDetector &&) = delete;
+  KiwiDetector &operator=(KiwiDetector const &) = delete;
+  KiwiDetector &operator=(KiwiDetector &&) = delete;
+
+ public:
+  // The input size may differ from the one in the configuration, as long as
+  // both sides are multiples of 32.
+  KiwiDetector(KiwiModel const &model, cv::Size const &inputSize = cv::Size(320, 320))
+    : m_confThreshold{0.3f}
+    , m_nmsThreshold{0.4f}
+    , m_inpSize{inputSize}
+    , m_classes{"Kiwi"}
+    , m_backend{makeYoloBackend(model)}
+    , m_decoder{m_confThreshold, m_nmsThreshold}
+  {
+  }
+
+  KiwiDetector(std::string const &modelConfiguration, std::string const &modelWeights,
+      cv::Size const &inputSize = cv::Size(320, 320))
+    : KiwiDetector(KiwiModel{"darknet", modelConfiguration, modelWeights, "opencv"}, inputSize)
+  {
+  }
+
+  std::vector<cv::Rect> detect(cv::Mat const &imga) {
+    return detectBlob(blob(imga), imga.size());
+  }
+
+  // Runs the detection on a frame that is already reduced to the network
+  // input (3 channels, inputSize()), as published by the preprocessing
+  // service. The boxes are scaled to frameSize.
+  std::vector<cv::Rect> detectPrepared(cv::Mat const &input, cv::Size const &frameSize) {
+    return detectBlob(blobPrepared(input), frameSize);
+  }
+
+  // The network input for a full frame (BGRA). Only reads the input size,
+  // so it may be called from another thread than the detection.
+  cv::Mat blob(cv::Mat const &imga) const {
+    // Remove the alpha channel (the network expects 3 channels).
+    cv::Mat img;
+    cv::cvtColor(imga, img, cv::COLOR_RGBA2RGB);
+    return blobPrepared(img);
+  }
+
+  cv::Mat blobPrepared(cv::Mat const &input) const {
+    cv::Mat blob;
+    cv::dnn::blobFromImage(input, blob, 1.0, m_inpSize, cv::Scalar(), false, false, CV_8U);
+    return blob;
+  }
+
+  cv::Size inputSize() const noexcept {
+    return m_inpSize;
+  }
+
+  // Runs the network once on an empty input, so that the layers allocate
+  // their buffers and pick their kernels before the first real frame. A
+  // network that runs batches is warmed up at its batch size.
+  void warmUp(int32_t batch = 1) {
+    int32_t const shape[] = {batch, 3, m_inpSize.height, m_inpSize.width};
+    std::vector<cv::Mat> outs;
+    m_backend->forward(cv::Mat(4, shape, CV_32F, cv::Scalar(0.0)), 1.0, outs);
+  }
+
+  // Inference time of the last frame in milliseconds.
+  double inferenceTime() {
+    return m_backend->inferenceTime();
+  }
+
+  // Runs the network on a blob made by blob() or blobPrepared() and returns
+  // the boxes scaled to frameSize. A float blob (as made by YoloInput) is
+  // taken as already normalised.
+  std::vector<cv::Rect> detectBlob(cv::Mat const &blob, cv::Size const &frameSize) {
+    // Run the detection.
+    std::vector<cv::Mat> outs;
+    m_backend->forward(blob, (blob.depth() == CV_32F) ? 1.0 : 1.0/255.0, outs);
+    return decode(outs, frameSize);
+  }
+
+  // The network input for several 3 channel images (BGR), stacked along the
+  // batch dimension.
+  cv::Mat blobBatch(std::vector<cv::Mat> const &inputs) const {
+    cv::Mat blob;
+    cv::dnn::blobFromImages(inputs, blob, 1.0, m_inpSize, cv::Scalar(), false, false, CV_8U);
+    return blob;
+  }
+
+  // One forward pass for a batch made by blobBatch(), or for a float batch
+  // (as made by YoloInput), taken as already normalised. The boxes of image n
+  // are scaled to frameSizes[n].
+  std::vector<std::vector<cv::Rect>> detectBlobBatch(cv::Mat const &blob, std::vector<cv::Size> const &frameSizes) {
+    std::vector<cv::Mat> outs;
+    m_backend->forward(blob, (blob.depth() == CV_32F) ? 1.0 : 1.0/255.0, outs);
+
+    // The region layers give [rows, cols] for a single image, and
+    // [batch, rows, cols] otherwise.
+    std::vector<std::vector<cv::Rect>> detections;
+    for (size_t n = 0; n < frameSizes.size(); ++n) {
+      std::vector<cv::Mat> imageOuts;
+      for (auto const &out : outs) {
+        if (out.dims == 3) {
+          imageOuts.push_back(cv::Mat(out.size[1], out.size[2], CV_32F, 
+                const_cast<float *>(out.ptr<float>(static_cast<int32_t>(n)))));
+        } else {
+          imageOuts.push_back(out);
+        }
+      }
+      detections.push_back(decode(imageOuts, frameSizes[n]));
+    }
+    return detections;
+  }
+
+ private:
+  std::vector<cv::Rect> decode(std::vector<cv::Mat> const &outs, cv::Size const &frameSize) {
+    m_decoder.reset();
+    for (auto const &out : outs) {
+      m_decoder.add(out, frameSize);
+    }
+    return m_decoder.finish();
+  }
+
+  float const m_confThreshold;  // Confidence threshold
+  float const m_nmsThreshold;  // Non-maximum suppression threshold
+  cv::Size const m_inpSize;  // Size of network's input image (320-faster, 608-more accurate)
+  std::vector<std::string> const m_classes;
+  std::unique_ptr<YoloBackend> m_backend;
+  YoloDecoder m_decoder;
+};
+
+// One message per detection (reusing nBox), or a single empty message when
+// nothing was found. predicted marks boxes that were propagated by the
+// tracker or repeated from an earlier frame instead of detected by the
+// network. For repeated boxes, age is the time in ms since the frame they
+// were detected in (at least 1); it is 0 otherwise.
+inline std::vector<opendlv::perception::KiwiBoundingBox> toKiwiBoundingBoxes(
+    std::vector<cv::Rect> const &boxes, uint32_t imageWidth, uint32_t imageHeight, bool predicted = false,
+    uint32_t age = 0) {
+  opendlv::perception::KiwiBoundingBox kiwi;
+  kiwi.imageWidth(imageWidth);
+  kiwi.imageHeight(imageHeight);
+  kiwi.nBox(static_cast<uint32_t>(boxes.size()));
+  kiwi.predicted(predicted);
+  kiwi.age(age);
+
+  std::vector<opendlv::perception::KiwiBoundingBox> kiwis;
+  if (boxes.size() == 0) {
+    kiwi.x(0);
+    kiwi.y(0);
+    kiwi.w(0);
+    kiwi.h(0);
+    kiwis.push_back(kiwi);
+  } else {
+    for (auto const &box : boxes) {
+      kiwi.x(box.x);
+      kiwi.y(box.y);
+      kiwi.w(box.width);
+      kiwi.h(box.height);
+      kiwis.push_back(kiwi);
+    }
+  }
+  return kiwis;
+}
+
+// All boxes of a frame in one message. sampleTime is that of the frame, in
+// microseconds.
+inline opendlv::perception::KiwiBoundingBoxArray toKiwiBoundingBoxArray(std::vector<cv::Rect> const &boxes,
+    uint32_t frameId, int64_t sampleTime, uint32_t imageWidth, uint32_t imageHeight, bool predicted = false,
+    uint32_t age = 0) {
+  std::string packed;
+  packBoxes(boxes, packed);
+  opendlv::perception::KiwiBoundingBoxArray kiwis;
+  kiwis.frameId(frameId);
+  kiwis.sampleTime(sampleTime);
+  kiwis.imageWidth(imageWidth);
+  kiwis.imageHeight(imageHeight);
+  kiwis.predicted(predicted);
+  kiwis.age(age);
+  kiwis.nBox(static_cast<uint32_t>(boxes.size()));
+  kiwis.boxes(packed);
+  return kiwis;
+}
+
+#endif
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KIWI_PIPELINE_HPP
+#define KIWI_PIPELINE_HPP
+
+#include "cluon-complete.hpp"
+#include "kiwi-detector.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One camera frame on its way through the pipeline.
+struct KiwiPipelineFrame {
+  uint64_t sequence{0};
+  cluon::data::TimeStamp sampleTime{};
+  cv::Mat blob{};
+  cv::Size frameSize{};
+  cv::Mat display{};
+  std::vector<cv::Rect> boxes{};
+  bool predicted{false};
+  uint32_t age{0};
+  double inferenceTime{0.0};
+};
+
+// Pipelined Kiwi detection. The caller prepares the network input of frame
+// N+1 while a pool of workers, each with its own network, runs the forward
+// pass and decoding of earlier frames. A publisher thread hands the results
+// back in frame order, so the frame after a slow one is held back until the
+// slow one is done.
+//
+// The OpenCV backend has no forwardAsync(), so the overlap comes from one
+// cv::dnn::Net per worker.
+class KiwiPipeline {
+ private:
+  KiwiPipeline(KiwiPipeline const &) = delete;
+  KiwiPipeline(KiwiPipeline &&) = delete;
+  KiwiPipeline &operator=(KiwiPipeline const &) = delete;
+  KiwiPipeline &operator=(KiwiPipeline &&) = delete;
+
+ public:
+  KiwiPipeline(KiwiModel const &model, uint32_t workers, std::function<void(KiwiPipelineFrame &&)> delegate)
+    : m_delegate{std::move(delegate)}
+    , m_detectors{}
+    , m_workers{}
+    , m_publisher{}
+    , m_mutex{}
+    , m_hasJob{}
+    , m_hasResult{}
+    , m_jobs{}
+    , m_results{}
+    , m_nextSequence{0}
+    , m_nextToPublish{0}
+    , m_runningWorkers{workers}
+    , m_isClosed{false}
+  {
+    for (uint32_t i{0}; i < workers; i++) {
+      m_detectors.emplace_back(new KiwiDetector{model});
+      m_detectors.back()->warmUp();
+    }
+    for (uint32_t i{0}; i < workers; i++) {
+      m_workers.emplace_back([this, i]() { work(*m_detectors[i]); });
+    }
+    m_publisher = std::thread([this]() { publish(); });
+  }
+
+  ~KiwiPipeline() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_isClosed = true;
+    }
+    m_hasJob.notify_all();
+    for (auto &worker : m_workers) {
+      worker.join();
+    }
+    m_publisher.join();
+  }
+
+  // Network input for a frame; may be called while the workers are busy.
+  cv::Mat blob(cv::Mat const &imga) const {
+    return m_detectors.front()->blob(imga);
+  }
+
+  cv::Mat blobPrepared(cv::Mat const &input) const {
+    return m_detectors.front()->blobPrepared(input);
+  }
+
+  cv::Size inputSize() const noexcept {
+    return m_detectors.front()->inputSize();
+  }
+
+  // Queues a frame for detection. If every worker is busy and a frame is
+  // already waiting, the frame is dropped (returns false) rather than adding
+  // latency, and it never gets a sequence number.
+  bool submit(KiwiPipelineFrame &&frame) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_jobs.empty()) {
+        return false;
+      }
+      frame.sequence = m_nextSequence++;
+      m_jobs.push_back(std::move(frame));
+    }
+    m_hasJob.notify_one();
+    return true;
+  }
+
+ private:
+  void work(KiwiDetector &detector) {
+    while (true) {
+      KiwiPipelineFrame frame;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_hasJob.wait(lock, [this]() { return m_isClosed || !m_jobs.empty(); });
+        if (m_jobs.empty()) {
+          break;
+        }
+        frame = std::move(m_jobs.front());
+        m_jobs.pop_front();
+      }
+
+      frame.boxes = detector.detectBlob(frame.blob, frame.frameSize);
+      frame.inferenceTime = detector.inferenceTime();
+      frame.blob.release();
+
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_results.emplace(frame.sequence, std::move(frame));
+      }
+      m_hasResult.notify_one();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_runningWorkers--;
+    }
+    m_hasResult.notify_one();
+  }
+
+  void publish() {
+    while (true) {
+      KiwiPipelineFrame frame;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_hasResult.wait(lock, [this]() {
+            return (!m_results.empty() && m_results.begin()->first == m_nextToPublish)
+              || (m_runningWorkers == 0);
+          });
+        if (m_results.empty() || m_results.begin()->first != m_nextToPublish) {
+          // All workers are done and every accepted frame is published.
+          break;
+        }
+        frame = std::move(m_results.begin()->second);
+        m_results.erase(m_results.begin());
+        m_nextToPublish++;
+      }
+      m_delegate(std::move(frame));
+    }
+  }
+
+  std::function<void(KiwiPipelineFrame &&)> m_delegate;
+  std::vector<std::unique_ptr<KiwiDetector>> m_detectors;
+  std::vector<std::thread> m_workers;
+  std::thread m_publisher;
+  std::mutex m_mutex;
+  std::condition_variable m_hasJob;
+  std::condition_variable m_hasResult;
+  std::deque<KiwiPipelineFrame> m_jobs;
+  std::map<uint64_t, KiwiPipelineFrame> m_results;
+  uint64_t m_nextSequence;
+  uint64_t m_nextToPublish;
+  uint32_t m_runningWorkers;
+  bool m_isClosed;
+};
+
+#endif
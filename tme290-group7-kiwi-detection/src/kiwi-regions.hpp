@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KIWI_REGIONS_HPP
+#define KIWI_REGIONS_HPP
+
+#include "kiwi-detector.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Square windows around the tracked boxes, for running the network on crops
+// instead of the whole frame. A window is twice the longer side of its box,
+// but at least minSide (so that a distant Kiwi is not enlarged beyond the
+// network input) and at most the shorter side of the frame, and it is
+// shifted to lie within the frame. A box that already lies within an earlier
+// window does not get a window of its own.
+inline std::vector<cv::Rect> regionsAround(std::vector<cv::Rect> const &boxes,
+    cv::Size const &frameSize, int32_t minSide) {
+  std::vector<cv::Rect> windows;
+  int32_t const maxSide{std::min(frameSize.width, frameSize.height)};
+  for (auto const &box : boxes) {
+    bool isCovered{false};
+    for (auto const &window : windows) {
+      isCovered |= ((box & window) == box);
+    }
+    if (isCovered || box.area() == 0) {
+      continue;
+    }
+
+    int32_t const side{std::min(std::max(2 * std::max(box.width, box.height), minSide), maxSide)};
+    int32_t const x{box.x + box.width / 2 - side / 2};
+    int32_t const y{box.y + box.height / 2 - side / 2};
+    windows.push_back(cv::Rect(std::min(std::max(x, 0), frameSize.width - side),
+          std::min(std::max(y, 0), frameSize.height - side), side, side));
+  }
+  return windows;
+}
+
+// Moves the detections of each window into frame pixels. Where windows
+// overlap, a Kiwi can be found twice; of boxes that overlap by more than
+// nmsThreshold, the first is kept.
+inline std::vector<cv::Rect> mergeRegionDetections(std::vector<std::vector<cv::Rect>> const &detections,
+    std::vector<cv::Rect> const &windows, float nmsThreshold) {
+  std::vector<cv::Rect> merged;
+  for (size_t i = 0; i < windows.size() && i < detections.size(); i++) {
+    for (auto const &detection : detections[i]) {
+      cv::Rect const box{detection + windows[i].tl()};
+      bool isDuplicate{false};
+      for (auto const &kept : merged) {
+        double const intersection{static_cast<double>((box & kept).area())};
+        double const united{static_cast<double>(box.area() + kept.area()) - intersection};
+        isDuplicate |= (united > 0.0 && intersection / united > nmsThreshold);
+      }
+      if (!isDuplicate) {
+        merged.push_back(box);
+      }
+    }
+  }
+  return merged;
+}
+
+// Runs a second network at a small, square input size on the windows
+// around the tracked boxes of a frame, all windows in one batch.
+class RegionDetector {
+ private:
+  RegionDetector(RegionDetector const &) = delete;
+  RegionDetector(RegionDetector &&) = delete;
+  RegionDetector &operator=(RegionDetector const &) = delete;
+  RegionDetector &operator=(RegionDetector &&) = delete;
+
+ public:
+  RegionDetector(KiwiModel const &model, int32_t side)
+    : m_side{side}
+    , m_detector{model, cv::Size(side, side)}
+    , m_windows{}
+    , m_windowSizes{}
+    , m_crops{}
+  {
+  }
+
+  void warmUp() {
+    m_detector.warmUp();
+  }
+
+  // Copies the windows around the boxes out of the frame (BGRA), so that
+  // the camera can be released before the network runs.
+  void crop(cv::Mat const &bgra, std::vector<cv::Rect> const &boxes) {
+    m_windows = regionsAround(boxes, bgra.size(), m_side);
+    m_windowSizes.clear();
+    m_crops.resize(m_windows.size());
+    for (size_t i = 0; i < m_windows.size(); i++) {
+      m_windowSizes.push_back(m_windows[i].size());
+      cv::cvtColor(bgra(m_windows[i]), m_crops[i], cv::COLOR_BGRA2BGR);
+    }
+  }
+
+  // The detections of the last cropped frame, in frame pixels.
+  std::vector<cv::Rect> detect() {
+    return mergeRegionDetections(m_detector.detectBlobBatch(m_detector.blobBatch(m_crops), m_windowSizes),
+        m_windows, 0.4f);
+  }
+
+  double inferenceTime() {
+    return m_detector.inferenceTime();
+  }
+
+ private:
+  int32_t const m_side;
+  KiwiDetector m_detector;
+  std::vector<cv::Rect> m_windows;
+  std::vector<cv::Size> m_windowSizes;
+  std::vector<cv::Mat> m_crops;
+};
+
+#endif
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KIWI_TILES_HPP
+#define KIWI_TILES_HPP
+
+#include "horizon-band.hpp"
+#include "kiwi-detector.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Tiles that cover the area (the frame or the horizon band) in the given
+// number of columns, neighbours overlapping by a share of a tile. The tiles
+// are square, unless the area is not as high as a tile, and as many rows as
+// needed are spread evenly over the area. A Kiwi that is cut by the edge of
+// one tile is whole in its neighbour as long as it is smaller than the
+// overlap.
+inline std::vector<cv::Rect> tilesOver(cv::Rect const &area, int32_t columns, double overlap) {
+  std::vector<cv::Rect> tiles;
+  if (columns < 1 || area.area() == 0) {
+    return tiles;
+  }
+  int32_t const width{std::min(static_cast<int32_t>(std::ceil(area.width / (columns - (columns - 1) * overlap))), area.width)};
+  int32_t const height{std::min(width, area.height)};
+  int32_t const rows{(height >= area.height) ? 1 :
+    static_cast<int32_t>(std::ceil((area.height - height * overlap) / (height * (1.0 - overlap))))};
+  for (int32_t row = 0; row < rows; row++) {
+    int32_t const y{area.y + ((rows > 1) ? row * (area.height - height) / (rows - 1) : 0)};
+    for (int32_t column = 0; column < columns; column++) {
+      int32_t const x{area.x + ((columns > 1) ? column * (area.width - width) / (columns - 1) : 0)};
+      tiles.push_back(cv::Rect(x, y, width, height));
+    }
+  }
+  return tiles;
+}
+
+// Moves the detections of each tile into frame pixels and suppresses the
+// duplicates across tiles. Of two boxes that overlap by more than
+// nmsThreshold, the larger is kept. A Kiwi in the overlap may also be found
+// whole in one tile and cut off in the other. The cut box then touches an
+// edge of its tile inside the area and lies mostly within the whole box,
+// so it is dropped as well.
+inline std::vector<cv::Rect> mergeTileDetections(std::vector<std::vector<cv::Rect>> const &detections,
+    std::vector<cv::Rect> const &tiles, cv::Rect const &area, float nmsThreshold) {
+  struct Candidate {
+    cv::Rect box;
+    bool isCut;
+  };
+  std::vector<Candidate> candidates;
+  for (size_t i = 0; i < tiles.size() && i < detections.size(); i++) {
+    cv::Rect const &tile{tiles[i]};
+    for (auto const &detection : detections[i]) {
+      cv::Rect const box{(detection + tile.tl()) & tile};
+      bool const isCut{(box.x <= tile.x && tile.x > area.x)
+        || (box.y <= tile.y && tile.y > area.y)
+        || (box.br().x >= tile.br().x && tile.br().x < area.br().x)
+        || (box.br().y >= tile.br().y && tile.br().y < area.br().y)};
+      candidates.push_back(Candidate{box, isCut});
+    }
+  }
+  std::stable_sort(candidates.begin(), candidates.end(),
+      [](Candidate const &a, Candidate const &b) { return a.box.area() > b.box.area(); });
+
+  std::vector<cv::Rect> merged;
+  for (auto const &candidate : candidates) {
+    bool isDuplicate{false};
+    for (auto const &kept : merged) {
+      double const intersection{static_cast<double>((candidate.box & kept).area())};
+      double const united{static_cast<double>(candidate.box.area() + kept.area()) - intersection};
+      isDuplicate |= (united > 0.0 && intersection / united > nmsThreshold);
+      isDuplicate |= (candidate.isCut && candidate.box.area() > 0 && intersection / candidate.box.area() > 0.7);
+    }
+    if (!isDuplicate && candidate.box.area() > 0) {
+      merged.push_back(candidate.box);
+    }
+  }
+  return merged;
+}
+
+// Chooses, per frame, between one pass over the whole area and a pass over
+// the tiles. A Kiwi is placed on the floor from the bottom row of its box,
+// for a level camera at height cameraZ (m). While the nearest Kiwi is
+// farther than tileDistance (m), it is small in a single pass and the tiles
+// are used; once it is closer than 80% of that, a single pass sees it well
+// and is cheaper. In between, the last choice is kept. With nothing
+// tracked, every searchInterval-th frame is tiled to find distant Kiwis.
+class TileScheduler {
+ public:
+  TileScheduler(double focalLength, double horizonRow, double cameraZ, double tileDistance, uint32_t searchInterval) noexcept
+    : m_focalLength{focalLength}
+    , m_horizonRow{horizonRow}
+    , m_cameraZ{cameraZ}
+    , m_tileDistance{tileDistance}
+    , m_searchInterval{searchInterval}
+    , m_framesSinceSearch{0}
+    , m_isTiled{false}
+    , m_nearestDistance{std::numeric_limits<double>::infinity()}
+  {
+  }
+
+  // Distance (m) to a Kiwi on the floor, or infinity above the horizon.
+  double distance(cv::Rect const &box) const noexcept {
+    double const belowHorizon{box.y + box.height - m_horizonRow};
+    return (belowHorizon > 0.0) ? m_focalLength * m_cameraZ / belowHorizon :
+      std::numeric_limits<double>::infinity();
+  }
+
+  // Takes the boxes of the last frame and tells whether to tile this one.
+  bool useTiles(std::vector<cv::Rect> const &boxes) noexcept {
+    m_nearestDistance = std::numeric_limits<double>::infinity();
+    for (auto const &box : boxes) {
+      m_nearestDistance = std::min(m_nearestDistance, distance(box));
+    }
+
+    if (boxes.empty()) {
+      m_isTiled = (++m_framesSinceSearch >= m_searchInterval);
+    } else if (m_nearestDistance > m_tileDistance) {
+      m_isTiled = true;
+    } else if (m_nearestDistance < 0.8 * m_tileDistance) {
+      m_isTiled = false;
+    }
+    if (m_isTiled) {
+      m_framesSinceSearch = 0;
+    }
+    return m_isTiled;
+  }
+
+  double nearestDistance() const noexcept {
+    return m_nearestDistance;
+  }
+
+ private:
+  double const m_focalLength;
+  double const m_horizonRow;
+  double const m_cameraZ;
+  double const m_tileDistance;
+  uint32_t const m_searchInterval;
+  uint32_t m_framesSinceSearch;
+  bool m_isTiled;
+  double m_nearestDistance;
+};
+
+// Runs the network on the tiles of the frames that the scheduler picks,
+// all tiles in one batch, each at inputWidth and the aspect of the tiles.
+class TiledDetector {
+ private:
+  TiledDetector(TiledDetector const &) = delete;
+  TiledDetector(TiledDetector &&) = delete;
+  TiledDetector &operator=(TiledDetector const &) = delete;
+  TiledDetector &operator=(TiledDetector &&) = delete;
+
+ public:
+  TiledDetector(KiwiModel const &model, std::vector<cv::Rect> const &tiles, cv::Rect const &area, int32_t inputWidth,
+      TileScheduler const &scheduler)
+    : m_tiles{tiles}
+    , m_area{area}
+    , m_tileSizes{}
+    , m_detector{model, bandInputSize(tiles.front(), inputWidth)}
+    , m_scheduler{scheduler}
+    , m_crops{}
+  {
+    for (auto const &tile : m_tiles) {
+      m_tileSizes.push_back(tile.size());
+    }
+  }
+
+  void warmUp() {
+    m_detector.warmUp(static_cast<int32_t>(m_tiles.size()));
+  }
+
+  // Takes the boxes of the last frame and tells whether to tile this one.
+  bool useTiles(std::vector<cv::Rect> const &boxes) noexcept {
+    return m_scheduler.useTiles(boxes);
+  }
+
+  double nearestDistance() const noexcept {
+    return m_scheduler.nearestDistance();
+  }
+
+  // Copies the tiles out of the frame (BGRA), so that the camera can be
+  // released before the network runs.
+  void crop(cv::Mat const &bgra) {
+    m_crops.resize(m_tiles.size());
+    for (size_t i = 0; i < m_tiles.size(); i++) {
+      cv::cvtColor(bgra(m_tiles[i]), m_crops[i], cv::COLOR_BGRA2BGR);
+    }
+  }
+
+  // The detections of the last cropped frame, in frame pixels.
+  std::vector<cv::Rect> detect() {
+    return mergeTileDetections(m_detector.detectBlobBatch(m_detector.blobBatch(m_crops), m_tileSizes),
+        m_tiles, m_area, 0.4f);
+  }
+
+  double inferenceTime() {
+    return m_detector.inferenceTime();
+  }
+
+ private:
+  std::vector<cv::Rect> const m_tiles;
+  cv::Rect const m_area;
+  std::vector<cv::Size> m_tileSizes;
+  KiwiDetector m_detector;
+  TileScheduler m_scheduler;
+  std::vector<cv::Mat> m_crops;
+};
+
+#endif
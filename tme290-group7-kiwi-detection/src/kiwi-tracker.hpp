@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KIWI_TRACKER_HPP
+#define KIWI_TRACKER_HPP
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Constant velocity Kalman filter for one box coordinate (position and
+// velocity per frame).
+class AxisFilter {
+ public:
+  explicit AxisFilter(float position) noexcept
+    : m_position{position}
+    , m_velocity{0.0f}
+    , m_p00{10.0f}
+    , m_p01{0.0f}
+    , m_p11{10.0f}
+  {
+  }
+
+  float position() const noexcept {
+    return m_position;
+  }
+
+  void predict(float processNoise) noexcept {
+    m_position += m_velocity;
+    // P = F P F' + Q, with F = [1 1; 0 1].
+    m_p00 += 2.0f * m_p01 + m_p11 + processNoise;
+    m_p01 += m_p11;
+    m_p11 += processNoise;
+  }
+
+  void update(float measurement, float measurementNoise) noexcept {
+    float const s{m_p00 + measurementNoise};
+    float const k0{m_p00 / s};
+    float const k1{m_p01 / s};
+    float const innovation{measurement - m_position};
+    m_position += k0 * innovation;
+    m_velocity += k1 * innovation;
+    m_p11 -= k1 * m_p01;
+    m_p01 -= k0 * m_p01;
+    m_p00 -= k0 * m_p00;
+  }
+
+ private:
+  float m_position;
+  float m_velocity;
+  float m_p00;
+  float m_p01;
+  float m_p11;
+};
+
+// Decides for each frame whether the network has to run, and propagates the
+// Kiwi boxes in between (SORT style: one Kalman filter per box coordinate,
+// greedy IoU association on the detected frames).
+//
+// A frame is a keyframe when the interval has passed since the last one, or
+// when a track's appearance check fails: the box content stored at the last
+// detection is searched for by template matching in a small window around
+// the predicted box, on a grey thumbnail of the frame. A good match also
+// corrects the predicted position. Kiwis that enter the view are found on
+// the next keyframe at the latest.
+class KiwiTracker {
+ private:
+  struct Track {
+    AxisFilter centerX;
+    AxisFilter centerY;
+    AxisFilter width;
+    AxisFilter height;
+    cv::Mat appearance;
+    uint32_t misses;
+  };
+
+ public:
+  KiwiTracker(cv::Size const &frameSize, uint32_t keyframeInterval) noexcept
+    : m_frameSize{frameSize}
+    , m_keyframeInterval{keyframeInterval}
+    , m_framesSinceKeyframe{keyframeInterval}
+    , m_tracks{}
+    , m_thumbnail{}
+    , m_scaleX{1.0f}
+    , m_scaleY{1.0f}
+  {
+  }
+
+  // Takes a grey thumbnail of a new frame (any size; it is stretched back to
+  // the frame) and tells whether the network has to run on it. Otherwise, the
+  // tracks have been moved to the frame.
+  bool isKeyframe(cv::Mat const &thumbnail) {
+    m_thumbnail = thumbnail;
+    m_scaleX = static_cast<float>(thumbnail.cols) / static_cast<float>(m_frameSize.width);
+    m_scaleY = static_cast<float>(thumbnail.rows) / static_cast<float>(m_frameSize.height);
+
+    if (advance()) {
+      return true;
+    }
+    for (auto &track : m_tracks) {
+      if (track.misses == 0 && !verify(track)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Moves the tracks to a new frame without looking at it, and tells whether
+  // the keyframe interval has passed.
+  bool advance() noexcept {
+    for (auto &track : m_tracks) {
+      predict(track);
+    }
+    return ++m_framesSinceKeyframe >= m_keyframeInterval;
+  }
+
+  // Associates the detections of a frame with the tracks. Detections that
+  // only cover parts of the frame do not restart the keyframe interval.
+  void update(std::vector<cv::Rect> const &detections, bool isFullFrame = true) {
+    if (isFullFrame) {
+      m_framesSinceKeyframe = 0;
+    }
+
+    std::vector<bool> isUsed(detections.size(), false);
+    for (auto &track : m_tracks) {
+      cv::Rect const predicted{box(track)};
+      double bestOverlap{0.3};
+      size_t best{detections.size()};
+      for (size_t i = 0; i < detections.size(); i++) {
+        double const o{overlap(predicted, detections[i])};
+        if (!isUsed[i] && o > bestOverlap) {
+          bestOverlap = o;
+          best = i;
+        }
+      }
+      if (best < detections.size()) {
+        isUsed[best] = true;
+        correct(track, detections[best]);
+        track.misses = 0;
+      } else {
+        track.misses++;
+      }
+    }
+    m_tracks.erase(std::remove_if(m_tracks.begin(), m_tracks.end(),
+          [](Track const &track) { return track.misses > 1; }), m_tracks.end());
+
+    for (size_t i = 0; i < detections.size(); i++) {
+      if (!isUsed[i]) {
+        cv::Rect const &d = detections[i];
+        Track track{AxisFilter{d.x + 0.5f * d.width}, AxisFilter{d.y + 0.5f * d.height},
+          AxisFilter{static_cast<float>(d.width)}, AxisFilter{static_cast<float>(d.height)}, cv::Mat{}, 0};
+        m_tracks.push_back(track);
+      }
+    }
+    for (auto &track : m_tracks) {
+      if (track.misses == 0) {
+        remember(track);
+      }
+    }
+  }
+
+  // The boxes of the tracks that were seen on the last keyframe.
+  std::vector<cv::Rect> boxes() const {
+    std::vector<cv::Rect> result;
+    for (auto const &track : m_tracks) {
+      if (track.misses == 0) {
+        result.push_back(box(track));
+      }
+    }
+    return result;
+  }
+
+ private:
+  void predict(Track &track) const noexcept {
+    track.centerX.predict(1.0f);
+    track.centerY.predict(1.0f);
+    track.width.predict(0.5f);
+    track.height.predict(0.5f);
+  }
+
+  void correct(Track &track, cv::Rect const &d) const noexcept {
+    track.centerX.update(d.x + 0.5f * d.width, 4.0f);
+    track.centerY.update(d.y + 0.5f * d.height, 4.0f);
+    track.width.update(static_cast<float>(d.width), 4.0f);
+    track.height.update(static_cast<float>(d.height), 4.0f);
+  }
+
+  cv::Rect box(Track const &track) const {
+    float const w{std::max(track.width.position(), 1.0f)};
+    float const h{std::max(track.height.position(), 1.0f)};
+    cv::Rect const r(static_cast<int32_t>(track.centerX.position() - 0.5f * w),
+        static_cast<int32_t>(track.centerY.position() - 0.5f * h),
+        static_cast<int32_t>(w), static_cast<int32_t>(h));
+    return r & cv::Rect(0, 0, m_frameSize.width, m_frameSize.height);
+  }
+
+  cv::Rect thumbnailBox(cv::Rect const &r) const {
+    cv::Rect const t(static_cast<int32_t>(r.x * m_scaleX), static_cast<int32_t>(r.y * m_scaleY),
+        static_cast<int32_t>(r.width * m_scaleX), static_cast<int32_t>(r.height * m_scaleY));
+    return t & cv::Rect(0, 0, m_thumbnail.cols, m_thumbnail.rows);
+  }
+
+  // Stores what the box looks like now.
+  void remember(Track &track) const {
+    cv::Rect const t{thumbnailBox(box(track))};
+    track.appearance = (t.area() > 0) ? m_thumbnail(t).clone() : cv::Mat{};
+  }
+
+  bool verify(Track &track) const {
+    // Too small to match reliably; far away Kiwis hardly move in the image.
+    if (track.appearance.cols < 6 || track.appearance.rows < 6) {
+      return true;
+    }
+
+    cv::Rect const predicted{thumbnailBox(box(track))};
+    int32_t const marginX{std::max(4, track.appearance.cols / 2)};
+    int32_t const marginY{std::max(4, track.appearance.rows / 2)};
+    cv::Rect const window{cv::Rect(predicted.x - marginX, predicted.y - marginY,
+        track.appearance.cols + 2 * marginX, track.appearance.rows + 2 * marginY)
+      & cv::Rect(0, 0, m_thumbnail.cols, m_thumbnail.rows)};
+    if (window.width < track.appearance.cols || window.height < track.appearance.rows) {
+      return false;
+    }
+
+    cv::Mat score;
+    cv::matchTemplate(m_thumbnail(window), track.appearance, score, cv::TM_CCOEFF_NORMED);
+    double best;
+    cv::Point location;
+    cv::minMaxLoc(score, nullptr, &best, nullptr, &location);
+    if (best < 0.6) {
+      return false;
+    }
+
+    float const centerX{(window.x + location.x + 0.5f * track.appearance.cols) / m_scaleX};
+    float const centerY{(window.y + location.y + 0.5f * track.appearance.rows) / m_scaleY};
+    track.centerX.update(centerX, 16.0f);
+    track.centerY.update(centerY, 16.0f);
+    return true;
+  }
+
+  static double overlap(cv::Rect const &a, cv::Rect const &b) {
+    double const intersection{static_cast<double>((a & b).area())};
+    double const united{static_cast<double>(a.area() + b.area()) - intersection};
+    return (united > 0.0) ? intersection / united : 0.0;
+  }
+
+  cv::Size const m_frameSize;
+  uint32_t const m_keyframeInterval;
+  uint32_t m_framesSinceKeyframe;
+  std::vector<Track> m_tracks;
+  cv::Mat m_thumbnail;
+  float m_scaleX;
+  float m_scaleY;
+};
+
+#endif
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LATENCY_GOVERNOR_HPP
+#define LATENCY_GOVERNOR_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Share of time that all CPUs were busy between two calls, from /proc/stat.
+class CpuLoad {
+ public:
+  CpuLoad() noexcept
+    : m_busy{0}
+    , m_total{0}
+  {
+  }
+
+  double sample() {
+    std::ifstream stat("/proc/stat");
+    std::string cpu;
+    uint64_t user{0}, nice{0}, system{0}, idle{0}, iowait{0}, irq{0}, softirq{0}, steal{0};
+    stat >> cpu >> user >> nice >> system >> idle >> iowait >> irq >> softirq >> steal;
+    if (!stat.good() || cpu != "cpu") {
+      return 0.0;
+    }
+    uint64_t const total{user + nice + system + idle + iowait + irq + softirq + steal};
+    uint64_t const busy{total - idle - iowait};
+    double const load{(total > m_total) ?
+      static_cast<double>(busy - m_busy) / static_cast<double>(total - m_total) : 0.0};
+    m_busy = busy;
+    m_total = total;
+    return load;
+  }
+
+ private:
+  uint64_t m_busy;
+  uint64_t m_total;
+};
+
+// Keeps the Kiwi detection within a per frame budget by choosing among a few
+// network input sizes, and, when even the smallest is too slow, by running
+// the network on every n-th frame only. The cost of a frame is the smoothed
+// forward time divided by n.
+//
+// Over budget, the input shrinks first and the rate drops last. With room to
+// spare, the rate is restored first, and the input only grows if the next
+// size (scaled by its pixel count) is expected to stay well within the
+// budget and the machine is not saturated, as another service (the cone
+// detection) would then slow down the larger network too. After each change,
+// the governor waits a few frames for the average to settle.
+class LatencyGovernor {
+ public:
+  // budget is in ms per camera frame. areaRatios[i] is the pixel count of
+  // input size i + 1 over that of size i, and level the size to start with.
+  LatencyGovernor(double budget, std::vector<double> const &areaRatios, size_t level, uint32_t maxRateDivisor)
+    : m_budget{budget}
+    , m_areaRatios{areaRatios}
+    , m_maxRateDivisor{maxRateDivisor}
+    , m_level{level}
+    , m_rateDivisor{1}
+    , m_frame{0}
+    , m_holdFrames{0}
+    , m_forwardTime{0.0}
+  {
+  }
+
+  size_t level() const noexcept {
+    return m_level;
+  }
+
+  uint32_t rateDivisor() const noexcept {
+    return m_rateDivisor;
+  }
+
+  double forwardTime() const noexcept {
+    return m_forwardTime;
+  }
+
+  // Whether the network runs on this frame.
+  bool shouldRun() noexcept {
+    return (m_frame++ % m_rateDivisor) == 0;
+  }
+
+  // Takes the forward time (ms) of a frame that was run, and the current CPU
+  // load (0 to 1).
+  void report(double forwardTime, double cpuLoad) noexcept {
+    m_forwardTime = (m_forwardTime > 0.0) ? 0.8 * m_forwardTime + 0.2 * forwardTime : forwardTime;
+    if (m_holdFrames > 0) {
+      m_holdFrames--;
+      return;
+    }
+
+    double const cost{m_forwardTime / m_rateDivisor};
+    bool const isSaturated{cpuLoad > 0.9};
+    if (cost > m_budget || (isSaturated && cost > 0.8 * m_budget)) {
+      if (m_level > 0) {
+        m_level--;
+        m_forwardTime /= m_areaRatios[m_level];
+      } else if (m_rateDivisor < m_maxRateDivisor) {
+        m_rateDivisor++;
+      } else {
+        return;
+      }
+      m_holdFrames = 5;
+    } else if (m_rateDivisor > 1) {
+      if (m_forwardTime / (m_rateDivisor - 1) < 0.8 * m_budget) {
+        m_rateDivisor--;
+        m_holdFrames = 5;
+      }
+    } else if (m_level < m_areaRatios.size() && !isSaturated
+        && m_forwardTime * m_areaRatios[m_level] < 0.7 * m_budget) {
+      m_forwardTime *= m_areaRatios[m_level];
+      m_level++;
+      m_holdFrames = 5;
+    }
+  }
+
+ private:
+  double const m_budget;
+  std::vector<double> const m_areaRatios;
+  uint32_t const m_maxRateDivisor;
+  size_t m_level;
+  uint32_t m_rateDivisor;
+  uint64_t m_frame;
+  uint32_t m_holdFrames;
+  double m_forwardTime;
+};
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// A file mapped read only into memory. The pages are those of the page
+// cache, so every process that maps the same file shares them, and nothing
+// is copied into private memory until the caller does so.
+class MappedFile {
+ private:
+  MappedFile(MappedFile const &) = delete;
+  MappedFile(MappedFile &&) = delete;
+  MappedFile &operator=(MappedFile const &) = delete;
+  MappedFile &operator=(MappedFile &&) = delete;
+
+ public:
+  explicit MappedFile(std::string const &path) noexcept
+    : m_data{nullptr}
+    , m_size{0}
+  {
+    int32_t const fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd < 0) {
+      return;
+    }
+    struct stat fileStatus;
+    if (0 == ::fstat(fd, &fileStatus) && fileStatus.st_size > 0) {
+      void *data = ::mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_SHARED, fd, 0);
+      if (data != MAP_FAILED) {
+        m_data = data;
+        m_size = static_cast<size_t>(fileStatus.st_size);
+        // The whole file is about to be parsed front to back.
+        ::madvise(m_data, m_size, MADV_SEQUENTIAL | MADV_WILLNEED);
+      }
+    }
+    ::close(fd);
+  }
+
+  ~MappedFile() {
+    if (m_data != nullptr) {
+      ::munmap(m_data, m_size);
+    }
+  }
+
+  bool valid() const noexcept {
+    return m_data != nullptr;
+  }
+
+  char const *data() const noexcept {
+    return static_cast<char const *>(m_data);
+  }
+
+  size_t size() const noexcept {
+    return m_size;
+  }
+
+ private:
+  void *m_data;
+  size_t m_size;
+};
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef METRICS_SERVER_HPP
+#define METRICS_SERVER_HPP
+
+#include "cluon-complete.hpp"
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Answers a request on a TCP port with the current metrics, as an HTTP
+// response that Prometheus can scrape: the text format, or JSON for a path
+// ending in ".json" (curl http://localhost:<port>/metrics.json). The values
+// are read once the request header is complete, on the thread of its
+// connection, so the code that updates them is not involved. Each
+// connection is answered once and then closed.
+class MetricsServer {
+ private:
+  MetricsServer(MetricsServer const &) = delete;
+  MetricsServer(MetricsServer &&) = delete;
+  MetricsServer &operator=(MetricsServer const &) = delete;
+  MetricsServer &operator=(MetricsServer &&) = delete;
+
+ public:
+  MetricsServer(uint16_t port, Metrics const &metrics)
+    : m_metrics(metrics)
+    , m_mutex{}
+    , m_wakeUp{}
+    , m_isRunning{true}
+    , m_answered{}
+    , m_connections{}
+    , m_closer{}
+    , m_server{port, [this](std::string &&, std::shared_ptr<cluon::TCPConnection> connection) {
+        accept(connection);
+      }}
+  {
+    m_closer = std::thread(&MetricsServer::close, this);
+  }
+
+  ~MetricsServer() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_isRunning = false;
+    }
+    m_wakeUp.notify_all();
+    m_closer.join();
+  }
+
+  bool valid() const noexcept {
+    return m_server.isRunning();
+  }
+
+ private:
+  // Longest request header that is read; a longer one is not answered.
+  static constexpr size_t MAX_REQUEST_SIZE{8192};
+
+  void accept(std::shared_ptr<cluon::TCPConnection> connection) {
+    std::weak_ptr<cluon::TCPConnection> weak{connection};
+    cluon::TCPConnection const *id{connection.get()};
+    std::string request;
+    bool isAnswered{false};
+    connection->setOnNewData([this, weak, id, request, isAnswered](std::string &&data,
+          std::chrono::system_clock::time_point &&) mutable {
+        // The header may come in several pieces.
+        if (isAnswered) {
+          return;
+        }
+        request.append(data);
+        bool const isComplete{request.find("\r\n\r\n") != std::string::npos};
+        if (!isComplete && request.size() <= MAX_REQUEST_SIZE) {
+          return;
+        }
+        isAnswered = true;
+        if (isComplete) {
+          if (auto current = weak.lock()) {
+            current->send(response(request));
+          }
+        }
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          m_answered.push_back(id);
+        }
+        m_wakeUp.notify_one();
+      });
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_connections.push_back(connection);
+  }
+
+  // A connection cannot be released from its own thread, so the answered
+  // ones, and the ones that the clients have closed, are released here.
+  void close() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_isRunning) {
+      m_wakeUp.wait_for(lock, std::chrono::seconds(1));
+      std::vector<std::shared_ptr<cluon::TCPConnection>> released;
+      auto isDone = [this](std::shared_ptr<cluon::TCPConnection> const &c) {
+          bool const isAnswered{std::find(m_answered.begin(), m_answered.end(), c.get()) != m_answered.end()};
+          // Still held by its own thread while it sends the response.
+          return (isAnswered && 1 == c.use_count()) || !c->isRunning();
+        };
+      for (auto &connection : m_connections) {
+        if (isDone(connection)) {
+          m_answered.erase(std::remove(m_answered.begin(), m_answered.end(), connection.get()), m_answered.end());
+          released.push_back(std::move(connection));
+        }
+      }
+      m_connections.erase(std::remove(m_connections.begin(), m_connections.end(), nullptr), m_connections.end());
+      lock.unlock();
+      released.clear();
+      lock.lock();
+    }
+  }
+
+  std::string response(std::string const &request) const {
+    size_t const lineEnd{request.find('\r')};
+    std::string const line{request.substr(0, lineEnd)};
+    bool const isJson{line.find(".json") != std::string::npos};
+    std::string const body{isJson ? m_metrics.json() : m_metrics.text()};
+    return std::string{"HTTP/1.1 200 OK\r\nContent-Type: "}
+      + (isJson ? "application/json" : "text/plain; version=0.0.4")
+      + "\r\nContent-Length: " + std::to_string(body.size())
+      + "\r\nConnection: close\r\n\r\n" + body;
+  }
+
+  Metrics const &m_metrics;
+  std::mutex m_mutex;
+  std::condition_variable m_wakeUp;
+  bool m_isRunning;
+  std::vector<cluon::TCPConnection const *> m_answered;
+  std::vector<std::shared_ptr<cluon::TCPConnection>> m_connections;
+  std::thread m_closer;
+  // Last, so that it stops accepting before the connections are released.
+  cluon::TCPServer m_server;
+};
+
+#endif
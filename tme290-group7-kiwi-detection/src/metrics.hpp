@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// A value that is set, such as the current operating point.
+class Gauge {
+ private:
+  Gauge(Gauge const &) = delete;
+  Gauge(Gauge &&) = delete;
+  Gauge &operator=(Gauge const &) = delete;
+  Gauge &operator=(Gauge &&) = delete;
+
+ public:
+  Gauge() noexcept
+    : m_value{0.0}
+  {
+  }
+
+  void set(double value) noexcept {
+    m_value.store(value, std::memory_order_relaxed);
+  }
+
+  double value() const noexcept {
+    return m_value.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<double> m_value;
+};
+
+// A value that only grows, such as a number of dropped frames.
+class Counter {
+ private:
+  Counter(Counter const &) = delete;
+  Counter(Counter &&) = delete;
+  Counter &operator=(Counter const &) = delete;
+  Counter &operator=(Counter &&) = delete;
+
+ public:
+  Counter() noexcept
+    : m_value{0}
+  {
+  }
+
+  void add(uint64_t n = 1) noexcept {
+    m_value.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  uint64_t value() const noexcept {
+    return m_value.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<uint64_t> m_value;
+};
+
+// How observed values, such as latencies in ms, are distributed over fixed
+// buckets, with their count and sum. Observing finds the bucket by a scan
+// over the few upper bounds and adds with relaxed atomics; the sum is
+// updated with a compare-and-swap loop, so no thread ever waits for a lock.
+class Histogram {
+ private:
+  Histogram(Histogram const &) = delete;
+  Histogram(Histogram &&) = delete;
+  Histogram &operator=(Histogram const &) = delete;
+  Histogram &operator=(Histogram &&) = delete;
+
+ public:
+  // bounds are the upper bounds of the buckets, in increasing order; a last
+  // bucket takes everything above.
+  explicit Histogram(std::vector<double> const &bounds)
+    : m_bounds{bounds}
+    , m_buckets{new std::atomic<uint64_t>[bounds.size() + 1]}
+    , m_sum{0.0}
+  {
+    for (size_t i = 0; i <= m_bounds.size(); i++) {
+      m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void observe(double value) noexcept {
+    size_t bucket{0};
+    while (bucket < m_bounds.size() && value > m_bounds[bucket]) {
+      bucket++;
+    }
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    double sum{m_sum.load(std::memory_order_relaxed)};
+    while (!m_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+    }
+  }
+
+  std::vector<double> const &bounds() const noexcept {
+    return m_bounds;
+  }
+
+  // The number of values in bucket i (not cumulative); bucket
+  // bounds().size() is the one above the last bound.
+  uint64_t bucket(size_t i) const noexcept {
+    return m_buckets[i].load(std::memory_order_relaxed);
+  }
+
+  double sum() const noexcept {
+    return m_sum.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::vector<double> const m_bounds;
+  std::unique_ptr<std::atomic<uint64_t>[]> m_buckets;
+  std::atomic<double> m_sum;
+};
+
+// Bucket bounds in ms for everything from a lock hold to a network pass.
+inline std::vector<double> latencyBuckets() {
+  return std::vector<double>{0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 25.0, 50.0, 100.0, 250.0, 500.0, 1000.0};
+}
+
+// Milliseconds since it was started, to observe durations.
+class Stopwatch {
+ public:
+  Stopwatch() noexcept
+    : m_start{std::chrono::steady_clock::now()}
+  {
+  }
+
+  void restart() noexcept {
+    m_start = std::chrono::steady_clock::now();
+  }
+
+  double elapsed() const noexcept {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point m_start;
+};
+
+// The metrics of a service, in the Prometheus text format or as JSON. Registering takes
+// a lock and is meant for start up; setting and adding are single relaxed
+// atomic operations and may be done on the hot path of any thread.
+class Metrics {
+ private:
+  Metrics(Metrics const &) = delete;
+  Metrics(Metrics &&) = delete;
+  Metrics &operator=(Metrics const &) = delete;
+  Metrics &operator=(Metrics &&) = delete;
+
+  struct Entry {
+    std::string name;
+    std::string help;
+    Gauge const *gauge;
+    Counter const *counter;
+    Histogram const *histogram;
+  };
+
+ public:
+  Metrics() noexcept
+    : m_mutex{}
+    , m_gauges{}
+    , m_counters{}
+    , m_histograms{}
+    , m_entries{}
+  {
+  }
+
+  // The returned references stay valid for the lifetime of the registry.
+  Gauge &gauge(std::string const &name, std::string const &help) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_gauges.emplace_back();
+    m_entries.push_back(Entry{name, help, &m_gauges.back(), nullptr, nullptr});
+    return m_gauges.back();
+  }
+
+  Counter &counter(std::string const &name, std::string const &help) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_counters.emplace_back();
+    m_entries.push_back(Entry{name, help, nullptr, &m_counters.back(), nullptr});
+    return m_counters.back();
+  }
+
+  Histogram &histogram(std::string const &name, std::string const &help,
+      std::vector<double> const &bounds = latencyBuckets()) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_histograms.emplace_back(bounds);
+    m_entries.push_back(Entry{name, help, nullptr, nullptr, &m_histograms.back()});
+    return m_histograms.back();
+  }
+
+  std::string text() const {
+    std::stringstream sstr;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto const &entry : m_entries) {
+      sstr << "# HELP " << entry.name << " " << entry.help << "\n";
+      if (entry.gauge != nullptr) {
+        sstr << "# TYPE " << entry.name << " gauge\n" << entry.name << " " << entry.gauge->value() << "\n";
+      } else if (entry.counter != nullptr) {
+        sstr << "# TYPE " << entry.name << " counter\n" << entry.name << " " << entry.counter->value() << "\n";
+      } else {
+        Histogram const &histogram{*entry.histogram};
+        sstr << "# TYPE " << entry.name << " histogram\n";
+        uint64_t count{0};
+        for (size_t i = 0; i < histogram.bounds().size(); i++) {
+          count += histogram.bucket(i);
+          sstr << entry.name << "_bucket{le=\"" << histogram.bounds()[i] << "\"} " << count << "\n";
+        }
+        count += histogram.bucket(histogram.bounds().size());
+        sstr << entry.name << "_bucket{le=\"+Inf\"} " << count << "\n"
+          << entry.name << "_sum " << histogram.sum() << "\n"
+          << entry.name << "_count " << count << "\n";
+      }
+    }
+    return sstr.str();
+  }
+
+  // The same values as one JSON object, keyed by name; a histogram is an
+  // object with its bucket bounds, its (not cumulative) counts and its sum.
+  // JSON has no infinity or NaN, so such a value is null.
+  std::string json() const {
+    auto number = [](double value) {
+        std::stringstream text;
+        if (std::isfinite(value)) {
+          text << value;
+        } else {
+          text << "null";
+        }
+        return text.str();
+      };
+    std::stringstream sstr;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    sstr << "{";
+    for (size_t n = 0; n < m_entries.size(); n++) {
+      Entry const &entry{m_entries[n]};
+      sstr << ((n > 0) ? "," : "") << "\n  \"" << entry.name << "\": ";
+      if (entry.gauge != nullptr) {
+        sstr << number(entry.gauge->value());
+      } else if (entry.counter != nullptr) {
+        sstr << entry.counter->value();
+      } else {
+        Histogram const &histogram{*entry.histogram};
+        sstr << "{\"bounds\": [";
+        for (size_t i = 0; i < histogram.bounds().size(); i++) {
+          sstr << ((i > 0) ? ", " : "") << histogram.bounds()[i];
+        }
+        sstr << "], \"counts\": [";
+        for (size_t i = 0; i <= histogram.bounds().size(); i++) {
+          sstr << ((i > 0) ? ", " : "") << histogram.bucket(i);
+        }
+        sstr << "], \"sum\": " << number(histogram.sum()) << "}";
+      }
+    }
+    sstr << "\n}\n";
+    return sstr.str();
+  }
+
+  // Replaces the file with the current values, for example for the textfile
+  // collector of the Prometheus node exporter. The file is written next to
+  // its final name and renamed, so readers never see half a file.
+  bool writeTo(std::string const &path) const {
+    std::string const temporary{path + ".tmp"};
+    {
+      std::ofstream file(temporary, std::ios::out | std::ios::trunc);
+      if (!file.good()) {
+        return false;
+      }
+      file << text();
+    }
+    return (0 == std::rename(temporary.c_str(), path.c_str()));
+  }
+
+ private:
+  mutable std::mutex m_mutex;
+  std::deque<Gauge> m_gauges;
+  std::deque<Counter> m_counters;
+  std::deque<Histogram> m_histograms;
+  std::deque<Entry> m_entries;
+};
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MOTION_GATE_HPP
+#define MOTION_GATE_HPP
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <cstdint>
+
+// Tells whether a frame differs enough from the last frame the network ran
+// on to run it again. The frames are compared as small grey thumbnails, in
+// blocks of 4x4 thumbnail pixels: the change is the largest mean absolute
+// difference of any block (in grey levels). The largest block is used so
+// that a small Kiwi moving in a still scene is not averaged away. Even in a
+// still scene, the network runs after maxSkips skipped frames.
+class MotionGate {
+ private:
+  MotionGate(MotionGate const &) = delete;
+  MotionGate(MotionGate &&) = delete;
+  MotionGate &operator=(MotionGate const &) = delete;
+  MotionGate &operator=(MotionGate &&) = delete;
+
+ public:
+  MotionGate(double threshold, uint32_t maxSkips)
+    : m_threshold{threshold}
+    , m_maxSkips{maxSkips}
+    , m_skips{0}
+    , m_change{0.0}
+    , m_small{}
+    , m_thumbnail{}
+    , m_reference{}
+    , m_difference{}
+    , m_blocks{}
+  {
+  }
+
+  // Whether the network may be skipped for this thumbnail. Counts the frame
+  // as skipped if so.
+  bool isStatic(cv::Mat const &thumbnail) {
+    if (m_reference.empty() || m_reference.size() != thumbnail.size()) {
+      return false;
+    }
+    cv::absdiff(thumbnail, m_reference, m_difference);
+    cv::resize(m_difference, m_blocks, cv::Size(thumbnail.cols / 4, thumbnail.rows / 4), 0, 0, cv::INTER_AREA);
+    cv::minMaxLoc(m_blocks, nullptr, &m_change);
+    if (m_change >= m_threshold || m_skips >= m_maxSkips) {
+      return false;
+    }
+    m_skips++;
+    return true;
+  }
+
+  // As above, for a frame (BGR or BGRA) that is first shrunk by divisor
+  // into a grey thumbnail.
+  bool isStatic(cv::Mat const &frame, int32_t divisor) {
+    cv::resize(frame, m_small, cv::Size(frame.cols / divisor, frame.rows / divisor), 0, 0, cv::INTER_AREA);
+    cv::cvtColor(m_small, m_thumbnail, (4 == frame.channels()) ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+    return isStatic(m_thumbnail);
+  }
+
+  // Takes the thumbnail of a frame the network ran on.
+  void setReference(cv::Mat const &thumbnail) {
+    thumbnail.copyTo(m_reference);
+    m_skips = 0;
+  }
+
+  // Takes the thumbnail of the last frame given to isStatic(frame, divisor).
+  void setReference() {
+    setReference(m_thumbnail);
+  }
+
+  // The change measured for the last thumbnail.
+  double change() const noexcept {
+    return m_change;
+  }
+
+ private:
+  double const m_threshold;
+  uint32_t const m_maxSkips;
+  uint32_t m_skips;
+  double m_change;
+  cv::Mat m_small;
+  cv::Mat m_thumbnail;
+  cv::Mat m_reference;
+  cv::Mat m_difference;
+  cv::Mat m_blocks;
+};
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROCESS_STATS_HPP
+#define PROCESS_STATS_HPP
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// A field of /proc/self/status in kB (for example "VmRSS", "RssFile"), or 0.
+inline uint64_t processStatus(std::string const &field) {
+  std::ifstream status("/proc/self/status");
+  std::string const key{field + ":"};
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, key.size(), key) == 0) {
+      return std::stoull(line.substr(key.size()));
+    }
+  }
+  return 0;
+}
+
+// Resident memory of the process in kB.
+inline uint64_t residentMemory() {
+  return processStatus("VmRSS");
+}
+
+// The part of the resident memory that other processes may share: mapped
+// files (such as the model weights) and shared memory, in kB.
+inline uint64_t sharedResidentMemory() {
+  return processStatus("RssFile") + processStatus("RssShmem");
+}
+
+// Time since the process was started by the kernel, in ms (with the 10 ms
+// resolution of /proc), including the loading of the libraries before main.
+inline double processAge() {
+  std::ifstream uptimeFile("/proc/uptime");
+  double uptime{0.0};
+  uptimeFile >> uptime;
+
+  // The start time is field 22 of /proc/self/stat, after the command name
+  // in parentheses (which may contain spaces).
+  std::ifstream statFile("/proc/self/stat");
+  std::string stat;
+  std::getline(statFile, stat);
+  std::stringstream fields(stat.substr(stat.rfind(')') + 2));
+  std::string field;
+  for (uint32_t i = 3; i < 22 && fields >> field; i++) {
+  }
+  uint64_t startTicks{0};
+  fields >> startTicks;
+  double const start{static_cast<double>(startTicks) / static_cast<double>(::sysconf(_SC_CLK_TCK))};
+  return (uptime - start) * 1000.0;
+}
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cluon-complete.hpp"
+#include "kiwi-detector.hpp"
+#include "scheduling.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgcodecs/imgcodecs.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Mean, standard deviation, 95th and 99th percentile and maximum.
+static void report(std::string const &name, std::vector<double> values, std::string const &unit) {
+  if (values.empty()) {
+    std::cout << name << ": no samples" << std::endl;
+    return;
+  }
+  std::sort(values.begin(), values.end());
+  double sum{0.0};
+  for (double v : values) {
+    sum += v;
+  }
+  double const mean{sum / values.size()};
+  double squares{0.0};
+  for (double v : values) {
+    squares += (v - mean) * (v - mean);
+  }
+  std::cout << std::fixed << std::setprecision(2) << name << " (" << values.size() << " samples): mean " << mean
+    << " " << unit << ", std dev " << std::sqrt(squares / values.size()) << " " << unit
+    << ", 95th percentile " << values[values.size() * 95 / 100] << " " << unit
+    << ", 99th percentile " << values[values.size() * 99 / 100] << " " << unit
+    << ", max " << values.back() << " " << unit << std::endl;
+}
+
+// Runs a control loop and the Kiwi detection side by side, with the same
+// scheduling settings as the services, while other threads keep all cores
+// busy, and reports how far the control loop misses its period and how much
+// the detection latency varies.
+int32_t main(int32_t argc, char **argv) {
+  auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+  if (0 == commandlineArguments.count("frames")) {
+    std::cerr << argv[0] << " measures the control period error and the Kiwi detection latency under load." << std::endl;
+    std::cerr << "Usage:   " << argv[0] << " --frames=<directory with .png/.jpg frames> [--size=<input size>] [--freq=<Hz>] [--duration=<s>] [--load-threads=<n>] "
+      << "[--scheduling-config=<file>] [--control-cpus=<list>] [--rt-priority=<1..99>] [--detection-cpus=<list>] [--threads=<n>]" << std::endl;
+    std::cerr << "         --load-threads: busy threads that compete for the cores (default: one per core)" << std::endl;
+    std::cerr << "         --scheduling-config: take the logic-control and kiwi-detection settings from this file; the flags take precedence" << std::endl;
+    std::cerr << "Example: " << argv[0] << " --frames=frames --freq=50 --duration=30 --control-cpus=3 --rt-priority=50 --detection-cpus=1-2 --threads=2" << std::endl;
+    return 1;
+  }
+  int32_t const SIZE{(commandlineArguments.count("size") != 0) ? std::stoi(commandlineArguments["size"]) : 320};
+  double const FREQ{(commandlineArguments.count("freq") != 0) ? std::stod(commandlineArguments["freq"]) : 50.0};
+  double const DURATION{(commandlineArguments.count("duration") != 0) ? std::stod(commandlineArguments["duration"]) : 20.0};
+  uint32_t const LOAD_THREADS{(commandlineArguments.count("load-threads") != 0) ?
+    static_cast<uint32_t>(std::stoi(commandlineArguments["load-threads"])) : std::thread::hardware_concurrency()};
+
+  // The settings of the two services, as they would read them.
+  std::map<std::string, std::string> controlArguments;
+  std::map<std::string, std::string> detectionArguments;
+  if (commandlineArguments.count("scheduling-config") != 0) {
+    controlArguments["scheduling-config"] = commandlineArguments["scheduling-config"];
+    detectionArguments["scheduling-config"] = commandlineArguments["scheduling-config"];
+  }
+  if (commandlineArguments.count("control-cpus") != 0) {
+    controlArguments["cpus"] = commandlineArguments["control-cpus"];
+  }
+  if (commandlineArguments.count("rt-priority") != 0) {
+    controlArguments["rt-priority"] = commandlineArguments["rt-priority"];
+  }
+  if (commandlineArguments.count("detection-cpus") != 0) {
+    detectionArguments["cpus"] = commandlineArguments["detection-cpus"];
+  }
+  if (commandlineArguments.count("threads") != 0) {
+    detectionArguments["threads"] = commandlineArguments["threads"];
+  }
+  Scheduling const CONTROL{schedulingFrom("logic-control", controlArguments)};
+  Scheduling const DETECTION{schedulingFrom("kiwi-detection", detectionArguments)};
+
+  std::vector<cv::String> files;
+  std::vector<cv::String> jpgs;
+  cv::glob(commandlineArguments["frames"] + "/*.png", files);
+  cv::glob(commandlineArguments["frames"] + "/*.jpg", jpgs);
+  files.insert(files.end(), jpgs.begin(), jpgs.end());
+  std::vector<cv::Mat> frames;
+  for (auto const &file : files) {
+    cv::Mat frame{cv::imread(file, cv::IMREAD_COLOR)};
+    if (!frame.empty()) {
+      frames.push_back(frame);
+    }
+  }
+  if (frames.empty()) {
+    std::cerr << argv[0] << ": No frames in " << commandlineArguments["frames"] << "." << std::endl;
+    return 1;
+  }
+
+  std::atomic<bool> isRunning{true};
+
+  // Load on every core, at normal priority, as the other services of a busy
+  // host would be.
+  std::vector<std::thread> load;
+  for (uint32_t i = 0; i < LOAD_THREADS; i++) {
+    load.emplace_back([&isRunning]() {
+        volatile uint64_t counter{0};
+        while (isRunning.load(std::memory_order_relaxed)) {
+          counter = counter + 1;
+        }
+      });
+  }
+
+  std::vector<double> latencies;
+  std::thread detection{[&]() {
+      pinThread(DETECTION.cpus);
+      if (DETECTION.threads > 0) {
+        cv::setNumThreads(DETECTION.threads);
+      }
+      KiwiDetector kiwiDetector{KiwiModel{}, cv::Size(SIZE, SIZE)};
+      kiwiDetector.detectPrepared(frames.front(), frames.front().size());
+      for (size_t i = 0; isRunning.load(std::memory_order_relaxed); i++) {
+        cv::Mat const &frame{frames[i % frames.size()]};
+        auto const start{std::chrono::steady_clock::now()};
+        kiwiDetector.detectPrepared(frame, frame.size());
+        latencies.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+      }
+    }};
+
+  // The same absolute-deadline loop as Od4Bus::timeTrigger, with an empty
+  // body, so that only the wake-up error is measured.
+  std::vector<double> periodErrors;
+  std::thread control{[&]() {
+      pinThread(CONTROL.cpus);
+      setRealtimePriority(CONTROL.priority);
+      auto const period{std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(1.0 / FREQ))};
+      auto const end{std::chrono::steady_clock::now() + std::chrono::duration<double>(DURATION)};
+      auto deadline{std::chrono::steady_clock::now() + period};
+      while (deadline < end) {
+        std::this_thread::sleep_until(deadline);
+        periodErrors.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - deadline).count());
+        deadline += period;
+      }
+    }};
+
+  control.join();
+  isRunning.store(false);
+  detection.join();
+  for (auto &thread : load) {
+    thread.join();
+  }
+
+  std::cout << LOAD_THREADS << " load threads, control at " << FREQ << " Hz on cores '" << CONTROL.cpus
+    << "' with priority " << CONTROL.priority << ", detection on cores '" << DETECTION.cpus
+    << "' with " << cv::getNumThreads() << " OpenCV threads" << std::endl;
+  report("control period error", periodErrors, "us");
+  report("detection latency", latencies, "ms");
+  return 0;
+}
@@ -17,11 +17,787 @@
 
 #include "cluon-complete.hpp"
 #include "opendlv-standard-message-set.hpp"
+#include "od4-bus.hpp"
+#include "kiwi-detector.hpp"
+#include "kiwi-pipeline.hpp"
+#include "horizon-band.hpp"
+#include "kiwi-cameras.hpp"
+#include "kiwi-regions.hpp"
+#include "kiwi-tiles.hpp"
+#include "kiwi-tracker.hpp"
+#include "latency-governor.hpp"
+#include "metrics.hpp"
+#include "metrics-server.hpp"
+#include "motion-gate.hpp"
+#include "process-stats.hpp"
+#include "scheduling.hpp"
+#include "async-log.hpp"
+#include "yolo-input.hpp"
 
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/dnn/dnn.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// The options of a run on one camera, as checked by main().
+struct KiwiSettings {
+  uint32_t width{0};
+  uint32_t height{0};
+  bool verbose{false};
+  bool legacyMessages{false};
+  bool preprocessed{false};
+  uint32_t pipeline{0};
+  uint32_t keyframeInterval{0};
+  uint32_t roiInterval{0};
+  int32_t roiSize{160};
+  double latencyBudget{0.0};
+  std::vector<int32_t> inputSizes{320};
+  bool hasBand{false};
+  cv::Rect band{};
+  std::vector<cv::Rect> tiles{};
+  int32_t tileInputWidth{320};
+  double cameraZ{0.095};
+  double cameraFovy{48.8};
+  double tileDistance{2.0};
+  uint32_t tileSearchInterval{4};
+  double motionThreshold{0.0};
+  uint32_t motionMaxSkips{30};
+  std::string metricsFile{};
+};
+
+struct KiwiMetrics {
+  explicit KiwiMetrics(Metrics &metrics)
+    : droppedFrames(metrics.counter("kiwi_detection_dropped_frames_total", "Frames dropped as all networks were busy"))
+    , skippedFrames(metrics.counter("kiwi_detection_skipped_frames_total", "Frames not run to stay within the latency budget"))
+    , inputSize(metrics.gauge("kiwi_detection_input_size_pixels", "Side of the network input"))
+    , rateDivisor(metrics.gauge("kiwi_detection_rate_divisor", "The network runs on every n-th frame"))
+    , forwardTime(metrics.gauge("kiwi_detection_forward_time_ms", "Smoothed forward time of the network"))
+    , cpuLoad(metrics.gauge("kiwi_detection_cpu_load_ratio", "Share of time all CPUs were busy"))
+    , ready(metrics.gauge("kiwi_detection_ready_ms", "Time from process start until the networks were loaded and warmed up"))
+    , firstPublish(metrics.gauge("kiwi_detection_first_publish_ms", "Time from process start until the first detections were sent"))
+    , residentMemory(metrics.gauge("kiwi_detection_resident_memory_bytes", "Resident memory of the process"))
+    , sharedMemory(metrics.gauge("kiwi_detection_shared_memory_bytes", "Resident memory backed by files or shared memory, which other processes may share"))
+    , tiledFrames(metrics.counter("kiwi_detection_tiled_frames_total", "Frames run on tiles instead of a single pass"))
+    , nearestDistance(metrics.gauge("kiwi_detection_nearest_distance_m", "Distance to the nearest Kiwi on the floor, or 0 if none is seen"))
+    , frames(metrics.counter("kiwi_detection_frames_total", "Camera frames received"))
+    , staticFrames(metrics.counter("kiwi_detection_static_frames_total", "Frames that repeated the last detections as the scene did not change"))
+    , udpRate(metrics.gauge("kiwi_detection_udp_datagrams_per_second", "UDP datagrams received on the OD4 session (with --udp-batch)"))
+    , udpCalls(metrics.counter("kiwi_detection_udp_receive_calls_total", "System calls that received UDP datagrams (with --udp-batch)"))
+    , udpDrops(metrics.counter("kiwi_detection_udp_drops_total", "UDP datagrams dropped by the kernel as the socket buffer was full (with --udp-batch)"))
+    , deliveredMessages(metrics.counter("kiwi_detection_messages_delivered_total", "Messages handed to a data trigger (with --udp-batch or --shm-bus)"))
+    , filteredMessages(metrics.counter("kiwi_detection_messages_filtered_total", "Messages dropped undecoded as nothing subscribed to them (with --udp-batch or --shm-bus)"))
+    , droppedLogRecords(metrics.counter("kiwi_detection_log_records_dropped_total", "Log records dropped as the log ring was full"))
+    , inferenceTimes(metrics.histogram("kiwi_detection_inference_ms", "Forward time of the network per frame that was run"))
+    , frameLatencies(metrics.histogram("kiwi_detection_frame_latency_ms", "Time from the camera sample to sending the detections"))
+    , cameraLockHolds(metrics.histogram("kiwi_detection_camera_lock_hold_ms", "Time the camera shared memory is held locked per frame"))
+  {
+  }
+
+  Counter &droppedFrames;
+  Counter &skippedFrames;
+  Gauge &inputSize;
+  Gauge &rateDivisor;
+  Gauge &forwardTime;
+  Gauge &cpuLoad;
+  Gauge &ready;
+  Gauge &firstPublish;
+  Gauge &residentMemory;
+  Gauge &sharedMemory;
+  Counter &tiledFrames;
+  Gauge &nearestDistance;
+  Counter &frames;
+  Counter &staticFrames;
+  Gauge &udpRate;
+  Counter &udpCalls;
+  Counter &udpDrops;
+  Counter &deliveredMessages;
+  Counter &filteredMessages;
+  Counter &droppedLogRecords;
+  Histogram &inferenceTimes;
+  Histogram &frameLatencies;
+  Histogram &cameraLockHolds;
+};
+
+// Takes the CPU load, the memory use and the counters of the OD4 session
+// and of the log into the metrics, at most once a second, and then writes
+// the metrics file if there is one.
+class MetricsSampler {
+ private:
+  MetricsSampler(MetricsSampler const &) = delete;
+  MetricsSampler(MetricsSampler &&) = delete;
+  MetricsSampler &operator=(MetricsSampler const &) = delete;
+  MetricsSampler &operator=(MetricsSampler &&) = delete;
+
+ public:
+  MetricsSampler(Metrics &metrics, KiwiMetrics &kiwiMetrics, std::string const &file)
+    : m_metrics(metrics)
+    , m_kiwiMetrics(kiwiMetrics)
+    , m_file{file}
+    , m_cpuLoad{}
+    , m_load{m_cpuLoad.sample()}
+    , m_lastSample{std::chrono::steady_clock::now()}
+  {
+  }
+
+  void sample(Od4Bus &od4, AsyncLog const &log) {
+    if (isDue()) {
+      record(od4.receiveStats(), od4.sharedMemoryStats(), log.dropped());
+    }
+  }
+
+  // As above, for the OD4 sessions of several cameras, added up.
+  void sample(std::vector<std::unique_ptr<Od4Bus>> const &od4s) {
+    if (!isDue()) {
+      return;
+    }
+    od4bus::ReceiveStats udp;
+    od4bus::DeliveryStats shm;
+    for (auto const &od4 : od4s) {
+      od4bus::ReceiveStats const received{od4->receiveStats()};
+      udp.calls += received.calls;
+      udp.drops += received.drops;
+      udp.datagramsPerSecond += received.datagramsPerSecond;
+      udp.delivery.delivered += received.delivery.delivered;
+      udp.delivery.filtered += received.delivery.filtered;
+      od4bus::DeliveryStats const delivered{od4->sharedMemoryStats()};
+      shm.delivered += delivered.delivered;
+      shm.filtered += delivered.filtered;
+    }
+    record(udp, shm, m_kiwiMetrics.droppedLogRecords.value());
+  }
+
+  // The CPU load at the last sample.
+  double load() const noexcept {
+    return m_load;
+  }
+
+ private:
+  bool isDue() {
+    auto const now{std::chrono::steady_clock::now()};
+    if (now - m_lastSample < std::chrono::seconds(1)) {
+      return false;
+    }
+    m_lastSample = now;
+    return true;
+  }
+
+  void record(od4bus::ReceiveStats const &udp, od4bus::DeliveryStats const &shm, uint64_t droppedLogRecords) {
+    m_load = m_cpuLoad.sample();
+    m_kiwiMetrics.cpuLoad.set(m_load);
+    m_kiwiMetrics.residentMemory.set(residentMemory() * 1024.0);
+    m_kiwiMetrics.sharedMemory.set(sharedResidentMemory() * 1024.0);
+    m_kiwiMetrics.udpRate.set(udp.datagramsPerSecond);
+    m_kiwiMetrics.udpCalls.add(udp.calls - m_kiwiMetrics.udpCalls.value());
+    m_kiwiMetrics.udpDrops.add(udp.drops - m_kiwiMetrics.udpDrops.value());
+    m_kiwiMetrics.deliveredMessages.add(udp.delivery.delivered + shm.delivered - m_kiwiMetrics.deliveredMessages.value());
+    m_kiwiMetrics.filteredMessages.add(udp.delivery.filtered + shm.filtered - m_kiwiMetrics.filteredMessages.value());
+    m_kiwiMetrics.droppedLogRecords.add(droppedLogRecords - m_kiwiMetrics.droppedLogRecords.value());
+    if (!m_file.empty()) {
+      m_metrics.writeTo(m_file);
+    }
+  }
+
+  Metrics &m_metrics;
+  KiwiMetrics &m_kiwiMetrics;
+  std::string const m_file;
+  CpuLoad m_cpuLoad;
+  double m_load;
+  std::chrono::steady_clock::time_point m_lastSample;
+};
+
+// Notes how long it took until the networks were loaded and warmed up,
+// and the memory in use by then.
+static void reportReady(KiwiMetrics &metrics, std::string const &program) {
+  metrics.ready.set(processAge());
+  metrics.residentMemory.set(residentMemory() * 1024.0);
+  metrics.sharedMemory.set(sharedResidentMemory() * 1024.0);
+  std::clog << program << ": Ready after " << metrics.ready.value() << " ms, resident memory "
+    << metrics.residentMemory.value() / 1048576.0 << " MB (" << metrics.sharedMemory.value() / 1048576.0 << " MB shared)." << std::endl;
+}
+
+// Sends the detections of a frame, with the time stamp of the frame, and
+// with --verbose displays them. May be called from the pipeline's
+// publisher thread.
+class KiwiPublisher {
+ private:
+  KiwiPublisher(KiwiPublisher const &) = delete;
+  KiwiPublisher(KiwiPublisher &&) = delete;
+  KiwiPublisher &operator=(KiwiPublisher const &) = delete;
+  KiwiPublisher &operator=(KiwiPublisher &&) = delete;
+
+ public:
+  // With a half resolution display frame, the boxes are scaled to it.
+  KiwiPublisher(KiwiSettings const &settings, Od4Bus &od4, bool isHalfDisplay, KiwiMetrics &metrics, AsyncLog &log)
+    : m_settings(settings)
+    , m_batch{od4}
+    , m_scale{isHalfDisplay ? 0.5 : 1.0}
+    , m_metrics(metrics)
+    , m_log(log)
+    , m_frameId{0}
+    , m_hasPublished{false}
+  {
+  }
+
+  void publish(KiwiPipelineFrame &&frame) {
+    static asynclog::Site firstPublishLog{"First detections sent {} ms after start."};
+
+    // Display the detections.
+    if (m_settings.verbose) {
+      cv::Mat &imga = frame.display;
+      for (auto const &box : frame.boxes) {
+        cv::rectangle(imga, cv::Point(static_cast<int32_t>(box.x * m_scale), static_cast<int32_t>(box.y * m_scale)),
+                      cv::Point(static_cast<int32_t>((box.x + box.width) * m_scale), static_cast<int32_t>((box.y + box.height) * m_scale)),
+                      cv::Scalar(0, 0, 255), 2);
+      }
+      // Display performance information.
+      std::string label = (frame.age > 0) ? cv::format("No change, detections from %u ms ago", frame.age) :
+        frame.predicted ? std::string{"Tracked, no inference"} :
+        cv::format("Inference time for a frame : %.2f ms", frame.inferenceTime);
+      cv::putText(imga, label, cv::Point(0, 15), cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 0, 255));
+
+      cv::imshow("Kiwi detection", imga);
+      cv::waitKey(1);
+    }
+
+    // send out the detection(s)
+    auto kiwis = toKiwiBoundingBoxArray(frame.boxes, m_frameId++, cluon::time::toMicroseconds(frame.sampleTime),
+        m_settings.width, m_settings.height, frame.predicted, frame.age);
+    m_batch.add(kiwis, frame.sampleTime, 0);
+    if (m_settings.legacyMessages) {
+      for (auto &kiwi : toKiwiBoundingBoxes(frame.boxes, m_settings.width, m_settings.height, frame.predicted, frame.age)) {
+        m_batch.add(kiwi, frame.sampleTime, 0);
+      }
+    }
+    m_batch.send();
+    m_metrics.frameLatencies.observe(static_cast<double>(cluon::time::deltaInMicroseconds(cluon::time::now(), frame.sampleTime)) / 1000.0);
+    if (!frame.predicted && frame.age == 0 && frame.inferenceTime > 0.0) {
+      m_metrics.inferenceTimes.observe(frame.inferenceTime);
+    }
+    if (!m_hasPublished) {
+      m_hasPublished = true;
+      double const age{processAge()};
+      m_metrics.firstPublish.set(age);
+      m_log.log(firstPublishLog, age);
+    }
+  }
+
+ private:
+  KiwiSettings const &m_settings;
+  Od4Batch m_batch;
+  double const m_scale;
+  KiwiMetrics &m_metrics;
+  AsyncLog &m_log;
+  uint32_t m_frameId;
+  bool m_hasPublished;
+};
+
+// Whether the shared memory area is large enough for an image of the given
+// size and OpenCV type; tells which area is too small otherwise.
+static bool isLargeEnough(cluon::SharedMemory &area, cv::Size const &size, int32_t type) {
+  size_t const bytes{static_cast<size_t>(size.area()) * CV_ELEM_SIZE(type)};
+  if (area.size() < bytes) {
+    std::cerr << "Shared memory '" << area.name() << "' has " << area.size() << " bytes, but a " << size.width << "x"
+      << size.height << " image needs " << bytes << "." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Copies the network input that tme290-group7-preprocessing published and,
+// with a half resolution area, the frame to display the detections on.
+static cv::Mat copyPreprocessed(cluon::SharedMemory &camera, cluon::SharedMemory *half, cv::Size const &inputSize,
+    KiwiPipelineFrame &frame, Histogram &cameraLockHolds) {
+  cv::Mat input;
+  camera.lock();
+  {
+    Stopwatch const held;
+    cv::Mat wrapped(inputSize, CV_8UC3, camera.data());
+    input = wrapped.clone();
+    frame.sampleTime = camera.getTimeStamp().second;
+    cameraLockHolds.observe(held.elapsed());
+  }
+  camera.unlock();
+
+  if (nullptr != half) {
+    half->lock();
+    {
+      cv::Mat wrapped(frame.frameSize.height / 2, frame.frameSize.width / 2, CV_8UC4, half->data());
+      frame.display = wrapped.clone();
+    }
+    half->unlock();
+  }
+  return input;
+}
+
+// Detects Kiwi cars in the frames of several cameras with one network. Frames
+// that arrive within the batching window share one forward pass, and the
+// detections of each camera are sent to that camera's OD4 session. The
+// forward time is observed once per batch, the latency once per frame.
+static void detectBatched(std::vector<std::string> const &names, std::vector<uint16_t> const &cids,
+    KiwiModel const &model, uint32_t width, uint32_t height, bool preprocessed, bool verbose, bool shmBus,
+    bool udpBatch, bool legacyMessages, std::chrono::milliseconds const &window, KiwiMetrics &metrics,
+    MetricsSampler &sampler, std::string const &program) {
+  std::vector<std::string> areas;
+  for (auto const &name : names) {
+    areas.push_back(preprocessed ? name + ".yolo" : name);
+  }
+  CameraBatcher cameras{areas};
+  if (!cameras.valid()) {
+    std::cerr << "Failed to attach to the shared memory of all cameras." << std::endl;
+    return;
+  }
+
+  std::vector<std::unique_ptr<Od4Bus>> od4s;
+  std::vector<std::unique_ptr<Od4Batch>> batches;
+  for (auto cid : cids) {
+    od4s.emplace_back(new Od4Bus{cid, shmBus, udpBatch});
+    batches.emplace_back(new Od4Batch{*od4s.back()});
+  }
+
+  // One network serves all cameras.
+  KiwiDetector kiwiDetector{model};
+  cv::Size const frameSize(width, height);
+  cv::Size const imageSize{preprocessed ? kiwiDetector.inputSize() : frameSize};
+  if (!cameras.start(imageSize, preprocessed ? CV_8UC3 : CV_8UC4)) {
+    std::cerr << "The shared memory of a camera is too small for a " << imageSize.width << "x" << imageSize.height
+      << ((preprocessed) ? " network input; check --yolo-size of the preprocessing." : " frame.") << std::endl;
+    return;
+  }
+  // Warmed up at the batch of all cameras, the one most forward passes run.
+  kiwiDetector.warmUp(static_cast<int32_t>(names.size()));
+
+  metrics.inputSize.set(kiwiDetector.inputSize().width);
+  metrics.rateDivisor.set(1);
+  reportReady(metrics, program);
+
+  // Raw frames are turned into the network input as with one camera, each
+  // straight into its place in the batch tensor.
+  YoloInput const yoloInput{frameSize, kiwiDetector.inputSize()};
+  std::vector<float> rowBuffer;
+  cv::Mat batchTensor;
+
+  std::vector<uint32_t> frameIds(names.size(), 0);
+  bool hasPublished{false};
+
+  auto isRunning = [&od4s]() {
+      for (auto const &od4 : od4s) {
+        if (!od4->isRunning()) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+  while (isRunning()) {
+    std::vector<CameraFrame> frames = cameras.next(window);
+    sampler.sample(od4s);
+    if (frames.empty()) {
+      continue;
+    }
+    metrics.frames.add(frames.size());
+
+    if (preprocessed) {
+      std::vector<cv::Mat> inputs;
+      for (auto const &frame : frames) {
+        inputs.push_back(frame.image);
+      }
+      batchTensor = kiwiDetector.blobBatch(inputs);
+    } else {
+      cv::Size const inputSize{kiwiDetector.inputSize()};
+      int32_t const shape[] = {static_cast<int32_t>(frames.size()), 3, inputSize.height, inputSize.width};
+      batchTensor.create(4, shape, CV_32F);
+      for (size_t i = 0; i < frames.size(); i++) {
+        int32_t const imageShape[] = {1, 3, inputSize.height, inputSize.width};
+        cv::Mat image(4, imageShape, CV_32F, batchTensor.ptr<float>(static_cast<int32_t>(i)));
+        yoloInput.run(frames[i].image, image, rowBuffer);
+      }
+    }
+    std::vector<cv::Size> frameSizes(frames.size(), frameSize);
+    std::vector<std::vector<cv::Rect>> detections = kiwiDetector.detectBlobBatch(batchTensor, frameSizes);
+    metrics.inferenceTimes.observe(kiwiDetector.inferenceTime());
+    metrics.forwardTime.set(kiwiDetector.inferenceTime());
+
+    for (size_t i = 0; i < frames.size(); i++) {
+      size_t const camera{frames[i].camera};
+      auto kiwis = toKiwiBoundingBoxArray(detections[i], frameIds[camera]++,
+          cluon::time::toMicroseconds(frames[i].sampleTime), width, height);
+      Od4Batch &batch = *batches[camera];
+      batch.add(kiwis, frames[i].sampleTime, 0);
+      if (legacyMessages) {
+        for (auto &kiwi : toKiwiBoundingBoxes(detections[i], width, height)) {
+          batch.add(kiwi, frames[i].sampleTime, 0);
+        }
+      }
+      batch.send();
+      metrics.frameLatencies.observe(static_cast<double>(cluon::time::deltaInMicroseconds(cluon::time::now(), frames[i].sampleTime)) / 1000.0);
+      if (!hasPublished) {
+        hasPublished = true;
+        metrics.firstPublish.set(processAge());
+      }
+
+      if (verbose && !preprocessed) {
+        cv::Mat imga = frames[i].image;
+        for (auto const &box : detections[i]) {
+          cv::rectangle(imga, cv::Point(box.x, box.y), cv::Point(box.x + box.width, box.y + box.height), 
+                        cv::Scalar(0, 0, 255), 2);
+        }
+        std::string label = cv::format("Inference time for %d frame(s) : %.2f ms", static_cast<int32_t>(frames.size()), kiwiDetector.inferenceTime());
+        cv::putText(imga, label, cv::Point(0, 15), cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 0, 255));
+        cv::imshow("Kiwi detection " + names[camera], imga);
+      }
+    }
+    if (verbose && !preprocessed) {
+      cv::waitKey(1);
+    }
+  }
+}
+
+// Runs n networks on worker threads, overlapping with the preparation of
+// the next frames. The frame loop only makes the network input, and the
+// detections are sent from the pipeline's publisher thread.
+static void detectPipelined(KiwiSettings const &settings, KiwiModel const &model, cluon::SharedMemory &camera,
+    cluon::SharedMemory *half, Od4Bus &od4, MetricsSampler &sampler, KiwiMetrics &metrics, AsyncLog &log,
+    KiwiPublisher &publisher, std::string const &program) {
+  static asynclog::Site droppedFramesLog{"All networks busy, dropped {} frame(s) so far.", 1000};
+
+  // The pipeline warms up its networks.
+  KiwiPipeline pipeline{model, settings.pipeline, [&publisher](KiwiPipelineFrame &&frame) {
+      publisher.publish(std::move(frame));
+    }};
+  cv::Size const frameSize(settings.width, settings.height);
+  if (settings.preprocessed && !isLargeEnough(camera, pipeline.inputSize(), CV_8UC3)) {
+    return;
+  }
+  YoloInput const yoloInput{frameSize, pipeline.inputSize()};
+  std::vector<float> rowBuffer;
+  metrics.inputSize.set(pipeline.inputSize().width);
+  metrics.rateDivisor.set(1);
+  reportReady(metrics, program);
+
+  // Endless loop; end the program by pressing Ctrl-C.
+  while (od4.isRunning()) {
+    KiwiPipelineFrame frame;
+    frame.frameSize = frameSize;
+
+    // Wait for a notification of a new frame.
+    camera.wait();
+    sampler.sample(od4, log);
+    metrics.frames.add();
+
+    if (settings.preprocessed) {
+      frame.blob = pipeline.blobPrepared(copyPreprocessed(camera, half, pipeline.inputSize(), frame, metrics.cameraLockHolds));
+    } else {
+      // A pipelined frame needs a tensor of its own, as earlier frames may
+      // still be in flight.
+      camera.lock();
+      {
+        Stopwatch const held;
+        cv::Mat wrapped(frameSize, CV_8UC4, camera.data());
+        yoloInput.run(wrapped, frame.blob, rowBuffer);
+        if (settings.verbose) {
+          frame.display = wrapped.clone();
+        }
+        frame.sampleTime = camera.getTimeStamp().second;
+        metrics.cameraLockHolds.observe(held.elapsed());
+      }
+      camera.unlock();
+    }
+
+    if (!pipeline.submit(std::move(frame))) {
+      metrics.droppedFrames.add();
+      if (settings.verbose) {
+        log.log(droppedFramesLog, metrics.droppedFrames.value());
+      }
+    }
+  }
+}
+
+// Runs the network on the frame loop's thread, with one network per input
+// size. Per frame, the modes decide what runs:
+// - the latency governor picks the input size and which frames are run,
+// - the tracker picks the keyframes; in between, its predictions are sent,
+//   or with --roi-interval, a smaller network runs on windows around them,
+// - the tile detector picks the keyframes that are run on tiles,
+// - the motion gate repeats the last detections while the scene is still.
+// With a band, the networks only see the band of rows around the horizon.
+class SerialDetection {
+ private:
+  SerialDetection(SerialDetection const &) = delete;
+  SerialDetection(SerialDetection &&) = delete;
+  SerialDetection &operator=(SerialDetection const &) = delete;
+  SerialDetection &operator=(SerialDetection &&) = delete;
+
+  // What is run on a frame.
+  struct Plan {
+    bool isKeyframe{true};
+    bool isTiled{false};
+    bool isStatic{false};
+  };
+
+ public:
+  SerialDetection(KiwiSettings const &settings, KiwiModel const &model, KiwiMetrics &metrics, AsyncLog &log)
+    : m_settings(settings)
+    , m_frameSize(settings.width, settings.height)
+    , m_metrics(metrics)
+    , m_log(log)
+    , m_detectors{}
+    , m_yoloInputs{}
+    , m_governor{}
+    , m_level{0}
+    , m_tracker{}
+    , m_regions{}
+    , m_tiles{}
+    , m_motionGate{}
+    , m_inputTensor{}
+    , m_rowBuffer{}
+    , m_smallFrame{}
+    , m_thumbnail{}
+    , m_lastBoxes{}
+    , m_lastInferenceTime{}
+  {
+    // The network input is made straight from the shared memory, and the
+    // same tensor and row buffer are reused for every frame.
+    for (auto size : settings.inputSizes) {
+      cv::Size const detectorSize{settings.hasBand ? bandInputSize(settings.band, size) : cv::Size(size, size)};
+      m_detectors.emplace_back(new KiwiDetector{model, detectorSize});
+      m_yoloInputs.emplace_back(settings.hasBand ? new YoloInput{m_frameSize, detectorSize, settings.band} :
+          new YoloInput{m_frameSize, detectorSize});
+    }
+    if (settings.latencyBudget > 0.0) {
+      std::vector<double> areaRatios;
+      for (size_t i = 1; i < settings.inputSizes.size(); i++) {
+        int32_t const side{settings.inputSizes[i]};
+        int32_t const previous{settings.inputSizes[i - 1]};
+        areaRatios.push_back(static_cast<double>(side * side) / (previous * previous));
+        if (side <= 320) {
+          m_level = i;
+        }
+      }
+      m_governor.reset(new LatencyGovernor{settings.latencyBudget, areaRatios, m_level, 4});
+    }
+
+    // The keyframe decision is taken on a grey thumbnail: a quarter of the
+    // frame, or the network input when it comes from the preprocessing.
+    uint32_t const trackerInterval{(settings.roiInterval > 0) ? settings.roiInterval : settings.keyframeInterval};
+    if (trackerInterval > 0) {
+      m_tracker.reset(new KiwiTracker{m_frameSize, trackerInterval});
+    }
+    if (settings.roiInterval > 0) {
+      m_regions.reset(new RegionDetector{model, settings.roiSize});
+    }
+    if (!settings.tiles.empty()) {
+      m_tiles.reset(new TiledDetector{model, settings.tiles, settings.band, settings.tileInputWidth,
+          TileScheduler{focalLength(m_frameSize, settings.cameraFovy), 0.5 * settings.height, settings.cameraZ,
+            settings.tileDistance, settings.tileSearchInterval}});
+    }
+    // Each frame is compared with the one the network last ran on, as a
+    // sixteenth (a quarter of the network input when preprocessed) in grey.
+    if (settings.motionThreshold > 0.0) {
+      m_motionGate.reset(new MotionGate{settings.motionThreshold, settings.motionMaxSkips});
+    }
+  }
+
+  // A first forward pass allocates the layers, so neither the first frame
+  // nor a later switch of the input size stalls.
+  void warmUp() {
+    for (auto &detector : m_detectors) {
+      detector->warmUp();
+    }
+    if (m_regions) {
+      m_regions->warmUp();
+    }
+    if (m_tiles) {
+      m_tiles->warmUp();
+    }
+    m_metrics.inputSize.set(m_detectors[m_level]->inputSize().width);
+    m_metrics.rateDivisor.set(m_governor ? m_governor->rateDivisor() : 1);
+  }
+
+  void run(cluon::SharedMemory &camera, cluon::SharedMemory *half, Od4Bus &od4, MetricsSampler &sampler,
+      KiwiPublisher &publisher) {
+    if (m_settings.preprocessed && !isLargeEnough(camera, m_detectors[m_level]->inputSize(), CV_8UC3)) {
+      return;
+    }
+
+    // Endless loop; end the program by pressing Ctrl-C.
+    while (od4.isRunning()) {
+      KiwiPipelineFrame frame;
+      frame.frameSize = m_frameSize;
+
+      // Wait for a notification of a new frame.
+      camera.wait();
+      sampler.sample(od4, m_log);
+      m_metrics.frames.add();
+      if (m_governor && !m_governor->shouldRun()) {
+        m_metrics.skippedFrames.add();
+        continue;
+      }
+
+      Plan const plan{m_settings.preprocessed ? preparePreprocessed(camera, half, frame) : prepare(camera, frame)};
+      detect(frame, plan, sampler.load());
+      publisher.publish(std::move(frame));
+    }
+  }
+
+ private:
+  // Takes what the plan needs from the frame while the camera is held. The
+  // fused conversion reads the frame once and costs less than copying it,
+  // so it runs while the camera is held. The full frame is only copied for
+  // display.
+  Plan prepare(cluon::SharedMemory &camera, KiwiPipelineFrame &frame) {
+    Plan plan;
+    camera.lock();
+    {
+      Stopwatch const held;
+      cv::Mat wrapped(m_frameSize, CV_8UC4, camera.data());
+      if (m_motionGate) {
+        plan.isStatic = m_motionGate->isStatic(wrapped, 16);
+      }
+      if (plan.isStatic) {
+        // Nothing else to prepare.
+      } else if (m_regions) {
+        plan.isKeyframe = m_tracker->advance() || m_tracker->boxes().empty();
+      } else if (m_tracker) {
+        cv::resize(wrapped, m_smallFrame, cv::Size(m_frameSize.width / 4, m_frameSize.height / 4), 0, 0, cv::INTER_AREA);
+        cv::cvtColor(m_smallFrame, m_thumbnail, cv::COLOR_BGRA2GRAY);
+        plan.isKeyframe = m_tracker->isKeyframe(m_thumbnail);
+      }
+      plan.isTiled = !plan.isStatic && plan.isKeyframe && m_tiles && useTiles();
+      if (plan.isStatic) {
+        // The last detections are repeated.
+      } else if (plan.isTiled) {
+        m_tiles->crop(wrapped);
+      } else if (plan.isKeyframe) {
+        m_yoloInputs[m_level]->run(wrapped, m_inputTensor, m_rowBuffer);
+      } else if (m_regions) {
+        m_regions->crop(wrapped, m_tracker->boxes());
+      }
+      if (m_settings.verbose) {
+        frame.display = wrapped.clone();
+      }
+      frame.sampleTime = camera.getTimeStamp().second;
+      m_metrics.cameraLockHolds.observe(held.elapsed());
+    }
+    camera.unlock();
+
+    frame.blob = m_inputTensor;
+    return plan;
+  }
+
+  // As above, for the network input made by the preprocessing; it is
+  // copied out first. Bands, tiles and windows do not apply to it.
+  Plan preparePreprocessed(cluon::SharedMemory &camera, cluon::SharedMemory *half, KiwiPipelineFrame &frame) {
+    Plan plan;
+    cv::Mat const input{copyPreprocessed(camera, half, m_detectors[m_level]->inputSize(), frame, m_metrics.cameraLockHolds)};
+    if (m_motionGate) {
+      plan.isStatic = m_motionGate->isStatic(input, 4);
+    }
+    if (m_tracker && !plan.isStatic) {
+      cv::cvtColor(input, m_thumbnail, cv::COLOR_BGR2GRAY);
+      plan.isKeyframe = m_tracker->isKeyframe(m_thumbnail);
+    }
+    if (plan.isKeyframe && !plan.isStatic) {
+      frame.blob = m_detectors[m_level]->blobPrepared(input);
+    }
+    return plan;
+  }
+
+  bool useTiles() {
+    bool const isTiled{m_tiles->useTiles(m_lastBoxes)};
+    double const distance{m_tiles->nearestDistance()};
+    m_metrics.nearestDistance.set(std::isinf(distance) ? 0.0 : distance);
+    return isTiled;
+  }
+
+  void detect(KiwiPipelineFrame &frame, Plan const &plan, double load) {
+    if (plan.isStatic) {
+      frame.boxes = m_lastBoxes;
+      frame.predicted = true;
+      frame.age = static_cast<uint32_t>(std::max<int64_t>(
+            cluon::time::deltaInMicroseconds(frame.sampleTime, m_lastInferenceTime) / 1000, 1));
+      m_metrics.staticFrames.add();
+    } else if (plan.isTiled) {
+      frame.boxes = m_tiles->detect();
+      frame.inferenceTime = m_tiles->inferenceTime();
+      m_metrics.forwardTime.set(frame.inferenceTime);
+      m_metrics.tiledFrames.add();
+      if (m_tracker) {
+        m_tracker->update(frame.boxes);
+      }
+    } else if (plan.isKeyframe) {
+      // Decoded for the frame, or for the band and then moved into the
+      // frame.
+      frame.boxes = m_yoloInputs[m_level]->toFrame(m_detectors[m_level]->detectBlob(frame.blob, m_yoloInputs[m_level]->decodeSize()));
+      frame.inferenceTime = m_detectors[m_level]->inferenceTime();
+      m_metrics.forwardTime.set(frame.inferenceTime);
+      if (m_tracker) {
+        m_tracker->update(frame.boxes);
+      }
+      if (m_governor) {
+        adapt(frame.inferenceTime, load);
+      }
+    } else if (m_regions) {
+      frame.boxes = m_regions->detect();
+      frame.inferenceTime = m_regions->inferenceTime();
+      m_tracker->update(frame.boxes, false);
+    } else {
+      frame.boxes = m_tracker->boxes();
+      frame.predicted = true;
+    }
+    if (m_motionGate && !frame.predicted) {
+      m_motionGate->setReference();
+      m_lastInferenceTime = frame.sampleTime;
+    }
+    m_lastBoxes = frame.boxes;
+  }
+
+  // Reports a forward pass to the governor and switches to the input size
+  // that it chose.
+  void adapt(double inferenceTime, double load) {
+    static asynclog::Site inputSizeLog{"Switched to a {} px network input."};
+
+    m_governor->report(inferenceTime, load);
+    m_metrics.forwardTime.set(m_governor->forwardTime());
+    if (m_governor->level() != m_level) {
+      m_level = m_governor->level();
+      m_metrics.inputSize.set(m_detectors[m_level]->inputSize().width);
+      if (m_settings.verbose) {
+        m_log.log(inputSizeLog, m_detectors[m_level]->inputSize().width);
+      }
+    }
+    m_metrics.rateDivisor.set(m_governor->rateDivisor());
+  }
+
+ private:
+  KiwiSettings const &m_settings;
+  cv::Size const m_frameSize;
+  KiwiMetrics &m_metrics;
+  AsyncLog &m_log;
+  std::vector<std::unique_ptr<KiwiDetector>> m_detectors;
+  std::vector<std::unique_ptr<YoloInput>> m_yoloInputs;
+  std::unique_ptr<LatencyGovernor> m_governor;
+  size_t m_level;
+  std::unique_ptr<KiwiTracker> m_tracker;
+  std::unique_ptr<RegionDetector> m_regions;
+  std::unique_ptr<TiledDetector> m_tiles;
+  std::unique_ptr<MotionGate> m_motionGate;
+  cv::Mat m_inputTensor;
+  std::vector<float> m_rowBuffer;
+  cv::Mat m_smallFrame;
+  cv::Mat m_thumbnail;
+  std::vector<cv::Rect> m_lastBoxes;
+  cluon::data::TimeStamp m_lastInferenceTime;
+};
+
 int32_t main(int32_t argc, char **argv) {
   int32_t retCode{1};
   auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
@@ -30,155 +806,210 @@ int32_t main(int32_t argc, char **argv) {
        (0 == commandlineArguments.count("width")) ||
        (0 == commandlineArguments.count("height")) ) {
     std::cerr << argv[0] << " attaches to a shared memory area containing an ARGB image." << std::endl;
-    std::cerr << "Usage:   " << argv[0] << " --cid=<OD4 session> --name=<name of shared memory area> [--verbose]" << std::endl;
-    std::cerr << "         --cid:    CID of the OD4Session to send and receive messages" << std::endl;
-    std::cerr << "         --name:   name of the shared memory area to attach" << std::endl;
+    std::cerr << "Usage:   " << argv[0] << " --cid=<OD4 session> --name=<name of shared memory area> [--preprocessed] [--pipeline=<n>] [--keyframe-interval=<n>] [--roi-interval=<n> [--roi-size=<px>]] [--latency-budget=<ms> [--input-sizes=<px,...>]] [--band=<top>,<bottom> | --band-auto] [--tiles=<columns>] [--motion-threshold=<grey levels>] [--model-weights=<file> [--model-config=<file>] [--model-format=darknet|onnx] [--model-backend=opencv|onnxruntime]] [--metrics-file=<path>] [--metrics-port=<port>] [--legacy-messages] [--shm-bus] [--udp-batch] [--cpus=<list>] [--threads=<n>] [--scheduling-config=<file>] [--verbose]" << std::endl;
+    std::cerr << "         --cid:    CID of the OD4Session to send and receive messages (one per camera, comma separated)" << std::endl;
+    std::cerr << "         --name:   name of the shared memory area to attach (several cameras are comma separated)" << std::endl;
     std::cerr << "         --width:  width of the frame" << std::endl;
     std::cerr << "         --height: height of the frame" << std::endl;
+    std::cerr << "         --preprocessed: attach to the network input of tme290-group7-preprocessing (<name>.yolo) instead of the frame" << std::endl;
+    std::cerr << "         --batch-window: with several cameras, time in ms to wait for the other cameras' frames (default 20)" << std::endl;
+    std::cerr << "         --pipeline: run n networks on worker threads, overlapping with the preparation and publishing of frames" << std::endl;
+    std::cerr << "         --keyframe-interval: run the network at least every n frames and track the Kiwis in between" << std::endl;
+    std::cerr << "         --roi-interval: run the network on the whole frame at least every n frames, and on windows around the tracked Kiwis in between" << std::endl;
+    std::cerr << "         --roi-size: network input size for the windows, a multiple of 32 (default 160)" << std::endl;
+    std::cerr << "         --latency-budget: adapt the network input size, and if needed the share of frames run, to keep the forward time per frame within the budget" << std::endl;
+    std::cerr << "         --input-sizes: input sizes for --latency-budget, ascending multiples of 32 (default 224,320,416)" << std::endl;
+    std::cerr << "         --band: only run the network on the rows from top to bottom, letterboxed at their own aspect" << std::endl;
+    std::cerr << "         --band-auto: compute the band from --camera-z (default 0.095 m), --camera-fovy (default 48.8 deg), --kiwi-height (default 0.15 m), --min-distance (default 0.5 m) and --band-margin (default 8 rows)" << std::endl;
+    std::cerr << "         --band-input-width: width of the network input for the band, a multiple of 32 (default 416)" << std::endl;
+    std::cerr << "         --tiles: run the network on this many overlapping columns of tiles over the frame or band, in one batch, while the nearest Kiwi is far" << std::endl;
+    std::cerr << "         --tile-overlap: share of a tile that overlaps its neighbour (default 0.2)" << std::endl;
+    std::cerr << "         --tile-input-width: width of the network input for a tile, a multiple of 32 (default 320)" << std::endl;
+    std::cerr << "         --tile-distance: use the tiles while the nearest Kiwi is farther than this, in m (default 2.0)" << std::endl;
+    std::cerr << "         --tile-search-interval: with no Kiwi in sight, tile every n-th frame (default 4)" << std::endl;
+    std::cerr << "         --motion-threshold: repeat the last detections instead of running the network while no block of the frame changed by this many grey levels since the network last ran" << std::endl;
+    std::cerr << "         --motion-max-skips: run the network after this many repeated frames even in a still scene (default 30)" << std::endl;
+    std::cerr << "         --model-weights: Darknet weights or ONNX model (default /opt/yolo/yolo-obj.weights)" << std::endl;
+    std::cerr << "         --model-config: Darknet configuration (default /opt/yolo/yolo-obj.cfg)" << std::endl;
+    std::cerr << "         --model-format: darknet or onnx (default from the weights' extension)" << std::endl;
+    std::cerr << "         --model-backend: opencv, or onnxruntime for ONNX models if built with ONNX Runtime (default opencv)" << std::endl;
+    std::cerr << "         --metrics-file: write the metrics in the Prometheus text format to this file every second" << std::endl;
+    std::cerr << "         --metrics-port: serve the metrics on this TCP port (Prometheus text format, or JSON for /metrics.json)" << std::endl;
+    std::cerr << "         --legacy-messages: also send one KiwiBoundingBox per box, besides the KiwiBoundingBoxArray of each frame" << std::endl;
+    std::cerr << "         --shm-bus: exchange messages with local services over shared memory (UDP is kept)" << std::endl;
+    std::cerr << "         --udp-batch: read UDP with several datagrams per system call" << std::endl;
+    std::cerr << "         --cpus: run on these cores only, e.g. 2-3 or 0,2" << std::endl;
+    std::cerr << "         --threads: number of OpenCV and network worker threads" << std::endl;
+    std::cerr << "         --scheduling-config: file with the settings above for all services (<service>.cpus=..., <service>.threads=..., <service>.rt-priority=...); the flags take precedence" << std::endl;
     std::cerr << "Example: " << argv[0] << " --cid=112 --name=img.argb --width=640 --height=480 --verbose" << std::endl;
-  } 
+    std::cerr << "         " << argv[0] << " --cid=111,112 --name=video0.argb,video1.argb --width=1280 --height=720" << std::endl;
+  }
   else {
     const std::string NAME{commandlineArguments["name"]};
-    const uint32_t WIDTH{static_cast<uint32_t>(std::stoi(commandlineArguments["width"]))};
-    const uint32_t HEIGHT{static_cast<uint32_t>(std::stoi(commandlineArguments["height"]))};
-    const bool VERBOSE{commandlineArguments.count("verbose") != 0};
+    const bool SHM_BUS{commandlineArguments.count("shm-bus") != 0};
+    const bool UDP_BATCH{commandlineArguments.count("udp-batch") != 0};
+    auto parameter = [&commandlineArguments](std::string const &key, double value) {
+        return (commandlineArguments.count(key) != 0) ? std::stod(commandlineArguments[key]) : value;
+      };
 
-    // Attach to the shared memory.
-    std::unique_ptr<cluon::SharedMemory> sharedMemory{new cluon::SharedMemory{NAME}};
-    if (sharedMemory && sharedMemory->valid()) {
+    KiwiSettings settings;
+    settings.width = static_cast<uint32_t>(std::stoi(commandlineArguments["width"]));
+    settings.height = static_cast<uint32_t>(std::stoi(commandlineArguments["height"]));
+    settings.verbose = (commandlineArguments.count("verbose") != 0);
+    settings.legacyMessages = (commandlineArguments.count("legacy-messages") != 0);
+    settings.preprocessed = (commandlineArguments.count("preprocessed") != 0);
+    settings.pipeline = static_cast<uint32_t>(parameter("pipeline", 0));
+    settings.keyframeInterval = static_cast<uint32_t>(parameter("keyframe-interval", 0));
+    settings.roiInterval = static_cast<uint32_t>(parameter("roi-interval", 0));
+    settings.roiSize = static_cast<int32_t>(parameter("roi-size", 160));
+    if (settings.pipeline > 0 && (settings.keyframeInterval > 0 || settings.roiInterval > 0)) {
+      std::cerr << argv[0] << ": --keyframe-interval and --roi-interval need the detections of a frame before the next one; they are not used with --pipeline." << std::endl;
+      return retCode;
+    }
+    if (settings.keyframeInterval > 0 && settings.roiInterval > 0) {
+      std::cerr << argv[0] << ": Use either --keyframe-interval or --roi-interval." << std::endl;
+      return retCode;
+    }
+    if (settings.roiInterval > 0 && settings.preprocessed) {
+      std::cerr << argv[0] << ": --roi-interval crops the full frame; it is not used with --preprocessed." << std::endl;
+      return retCode;
+    }
+    settings.latencyBudget = parameter("latency-budget", 0.0);
+    if (settings.latencyBudget > 0.0) {
+      settings.inputSizes.clear();
+      for (auto const &size : stringtoolbox::split(((commandlineArguments.count("input-sizes") != 0) ?
+              commandlineArguments["input-sizes"] : std::string{"224,320,416"}) + ",", ',')) {
+        if (!size.empty()) {
+          settings.inputSizes.push_back(std::stoi(size));
+        }
+      }
+      if (settings.inputSizes.empty() || settings.pipeline > 0 || settings.keyframeInterval > 0 || settings.roiInterval > 0
+          || settings.preprocessed) {
+        std::cerr << argv[0] << ": --latency-budget needs at least one input size, and is not used with --pipeline, --keyframe-interval, --roi-interval or --preprocessed." << std::endl;
+        return retCode;
+      }
+    }
+    // Kiwis on the floor only appear in a band of rows around the horizon.
+    settings.hasBand = (commandlineArguments.count("band") != 0 || commandlineArguments.count("band-auto") != 0);
+    settings.cameraZ = parameter("camera-z", 0.095);
+    settings.cameraFovy = parameter("camera-fovy", 48.8);
+    settings.band = cv::Rect(0, 0, static_cast<int32_t>(settings.width), static_cast<int32_t>(settings.height));
+    if (commandlineArguments.count("band") != 0) {
+      const std::vector<std::string> ROWS{stringtoolbox::split(commandlineArguments["band"], ',')};
+      if (ROWS.size() == 2) {
+        int32_t const top{std::max(std::stoi(ROWS[0]), 0)};
+        int32_t const bottom{std::min(std::stoi(ROWS[1]), static_cast<int32_t>(settings.height))};
+        settings.band = cv::Rect(0, top, static_cast<int32_t>(settings.width), std::max(bottom - top, 0));
+      } else {
+        settings.band = cv::Rect();
+      }
+    } else if (settings.hasBand) {
+      settings.band = horizonBand(cv::Size(settings.width, settings.height), settings.cameraZ, settings.cameraFovy,
+          parameter("kiwi-height", 0.15), parameter("min-distance", 0.5), static_cast<int32_t>(parameter("band-margin", 8)));
+    }
+    if (settings.hasBand) {
+      if (settings.band.area() == 0 || settings.pipeline > 0 || settings.preprocessed) {
+        std::cerr << argv[0] << ": --band takes the top and bottom row, and is not used with --pipeline or --preprocessed." << std::endl;
+        return retCode;
+      }
+      if (settings.latencyBudget <= 0.0) {
+        settings.inputSizes = {static_cast<int32_t>(parameter("band-input-width", 416))};
+      }
+      std::clog << argv[0] << ": Running the network on rows " << settings.band.y << " to " << settings.band.y + settings.band.height << "." << std::endl;
+    }
+    // Distant Kiwis are found on overlapping tiles of the frame or band.
+    const int32_t TILES{static_cast<int32_t>(parameter("tiles", 0))};
+    if (TILES > 0) {
+      settings.tiles = tilesOver(settings.band, TILES, parameter("tile-overlap", 0.2));
+      if (settings.tiles.empty() || settings.pipeline > 0 || settings.preprocessed || settings.latencyBudget > 0.0) {
+        std::cerr << argv[0] << ": --tiles takes the number of columns, and is not used with --pipeline, --preprocessed or --latency-budget." << std::endl;
+        return retCode;
+      }
+      settings.tileInputWidth = static_cast<int32_t>(parameter("tile-input-width", 320));
+      settings.tileDistance = parameter("tile-distance", 2.0);
+      settings.tileSearchInterval = static_cast<uint32_t>(parameter("tile-search-interval", 4));
+      std::clog << argv[0] << ": Using " << settings.tiles.size() << " tiles of " << settings.tiles.front().width << "x" << settings.tiles.front().height << " while Kiwis are far." << std::endl;
+    }
+    // In a still scene, the last detections are repeated.
+    settings.motionThreshold = parameter("motion-threshold", 0.0);
+    settings.motionMaxSkips = static_cast<uint32_t>(parameter("motion-max-skips", 30));
+    if (settings.motionThreshold > 0.0 && settings.pipeline > 0) {
+      std::cerr << argv[0] << ": --motion-threshold compares with the frame of the last detections; it is not used with --pipeline." << std::endl;
+      return retCode;
+    }
+    const KiwiModel MODEL{kiwiModelFrom(commandlineArguments)};
+    if (!MODEL.valid()) {
+      std::cerr << argv[0] << ": Unsupported model " << MODEL.name() << "." << std::endl;
+      return retCode;
+    }
+    settings.metricsFile = (commandlineArguments.count("metrics-file") != 0) ? commandlineArguments["metrics-file"] : "";
+    const uint16_t METRICS_PORT{static_cast<uint16_t>((commandlineArguments.count("metrics-port") != 0) ?
+      std::stoi(commandlineArguments["metrics-port"]) : 0)};
+
+    // Stay on the given cores with at most the given number of workers,
+    // before any thread or network is created, so that all inherit them.
+    const Scheduling SCHEDULING{schedulingFrom("kiwi-detection", commandlineArguments)};
+    pinThread(SCHEDULING.cpus);
+    if (SCHEDULING.threads > 0) {
+      cv::setNumThreads(SCHEDULING.threads);
+    }
+
+    Metrics metrics;
+    KiwiMetrics kiwiMetrics{metrics};
+    std::unique_ptr<MetricsServer> metricsServer{(METRICS_PORT > 0) ? new MetricsServer{METRICS_PORT, metrics} : nullptr};
+    if (metricsServer && !metricsServer->valid()) {
+      std::cerr << argv[0] << ": Could not serve the metrics on port " << METRICS_PORT << "." << std::endl;
+    }
+    MetricsSampler sampler{metrics, kiwiMetrics, settings.metricsFile};
+
+    // Several cameras share one network and batched forward passes.
+    if (NAME.find(',') != std::string::npos) {
+      const std::vector<std::string> NAMES{stringtoolbox::split(NAME, ',')};
+      std::vector<uint16_t> cids;
+      for (auto const &cid : stringtoolbox::split(commandlineArguments["cid"] + ",", ',')) {
+        if (!cid.empty()) {
+          cids.push_back(static_cast<uint16_t>(std::stoi(cid)));
+        }
+      }
+      const std::chrono::milliseconds BATCH_WINDOW{(commandlineArguments.count("batch-window") != 0) ?
+        std::stoi(commandlineArguments["batch-window"]) : 20};
+      if (cids.size() != NAMES.size() || settings.pipeline > 0 || settings.keyframeInterval > 0 || settings.roiInterval > 0
+          || settings.latencyBudget > 0.0 || settings.hasBand || TILES > 0 || settings.motionThreshold > 0.0) {
+        std::cerr << argv[0] << ": Give one CID per camera; --pipeline, --keyframe-interval, --roi-interval, --latency-budget, --band, --tiles and --motion-threshold are not used with several cameras." << std::endl;
+        return retCode;
+      }
+      detectBatched(NAMES, cids, MODEL, settings.width, settings.height, settings.preprocessed, settings.verbose, SHM_BUS,
+          UDP_BATCH, settings.legacyMessages, BATCH_WINDOW, kiwiMetrics, sampler, argv[0]);
+      return 0;
+    }
+
+    // Attach to the shared memory. With preprocessing, the detections are
+    // displayed on the half resolution frame.
+    std::unique_ptr<cluon::SharedMemory> sharedMemory{new cluon::SharedMemory{settings.preprocessed ? NAME + ".yolo" : NAME}};
+    std::unique_ptr<cluon::SharedMemory> halfMemory{(settings.preprocessed && settings.verbose) ? new cluon::SharedMemory{NAME + ".half"} : nullptr};
+    // The network input of the preprocessing is checked once the networks
+    // are loaded, as its size is theirs.
+    cv::Size const frameSize(settings.width, settings.height);
+    if (sharedMemory && sharedMemory->valid() && (!halfMemory || halfMemory->valid())
+        && (settings.preprocessed || isLargeEnough(*sharedMemory, frameSize, CV_8UC4))
+        && (!halfMemory || isLargeEnough(*halfMemory, cv::Size(frameSize.width / 2, frameSize.height / 2), CV_8UC4))) {
       std::clog << argv[0] << ": Attached to shared memory '" << sharedMemory->name() << " (" << sharedMemory->size() << " bytes)." << std::endl;
 
       // Interface to a running OpenDaVINCI session; here, you can send and receive messages.
-      cluon::OD4Session od4{static_cast<uint16_t>(std::stoi(commandlineArguments["cid"]))};
-
-      // Initialize the parameters.
-      float confThreshold = 0.3f;  // Confidence threshold
-      float nmsThreshold = 0.4f;  // Non-maximum suppression threshold
-      uint32_t inpWidth = 320;  // Width of network's input image (320-faster, 608-more accurate)
-      uint32_t inpHeight = 320;  // Height of network's input image (320-faster, 608-more accurate)
-      cv::Size inpSize(inpWidth, inpHeight);
-
-      std::vector<std::string> classes;
-      classes.push_back("Kiwi");
-      
-      // Load the network.
-      std::string modelConfiguration = "/opt/yolo/yolo-obj.cfg";
-      std::string modelWeights = "/opt/yolo/yolo-obj.weights";
-      cv::dnn::Net net = cv::dnn::readNetFromDarknet(modelConfiguration, modelWeights);
-      net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
-      net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
-      std::vector<cv::String> outNames = net.getUnconnectedOutLayersNames();
-
-      // Endless loop; end the program by pressing Ctrl-C.
-      while (od4.isRunning()) {
-        cv::Mat imga,img;
-
-        // Wait for a notification of a new frame.
-        sharedMemory->wait();
-
-        // Copy the image from memory.
-        sharedMemory->lock();
-        {
-          cv::Mat wrapped(HEIGHT, WIDTH, CV_8UC4, sharedMemory->data());
-          imga = wrapped.clone();
-        }
-        sharedMemory->unlock();
-
-        // Remove the alpha channel (the network expects 3 channels).
-        cv::cvtColor(imga, img, cv::COLOR_RGBA2RGB);
-        cv::Mat blob;
-        cv::dnn::blobFromImage(img, blob, 1.0, inpSize, cv::Scalar(), false, false, CV_8U);
-
-        // Run the detection.
-        net.setInput(blob, "", 1.0f/255.0f, cv::Scalar(0,0,0));
-        std::vector<cv::Mat> outs;
-        net.forward(outs, outNames);
-
-        // Process the result.
-        std::vector<uint32_t> classIds;
-        std::vector<float> confidences;
-        std::vector<cv::Rect> boxes;      
-        for (size_t i = 0; i < outs.size(); ++i) {
-          float* data = (float*)outs[i].data;
-          for (int j = 0; j < outs[i].rows; ++j, data += outs[i].cols) {
-            cv::Mat scores = outs[i].row(j).colRange(5, outs[i].cols);
-            cv::Point classIdPoint;
-            double confidence;
-            cv::minMaxLoc(scores, 0, &confidence, 0, &classIdPoint);
-            if (confidence > confThreshold) {
-              uint32_t centerX = (uint32_t)(data[0] * img.cols);
-              uint32_t centerY = (uint32_t)(data[1] * img.rows);
-              uint32_t width = (uint32_t)(data[2] * img.cols);
-              uint32_t height = (uint32_t)(data[3] * img.rows);
-              uint32_t left = centerX - width / 2;
-              uint32_t top = centerY - height / 2;
-              classIds.push_back(classIdPoint.x);
-              confidences.push_back((float)confidence);
-              boxes.push_back(cv::Rect(left, top, width, height));
-            }
-          }
-        }
-        // Perform non maximum suppression to eliminate redundant boxes.
-        std::vector<int32_t> indices;
-        cv::dnn::NMSBoxes(boxes, confidences, confThreshold, nmsThreshold, indices);
-
-        // Display the detections.
-        if (VERBOSE) {
-          for (size_t i = 0; i < indices.size(); ++i) {
-            uint32_t idx = indices[i];
-            cv::Rect box = boxes[idx];
-            cv::rectangle(img, cv::Point(box.x, box.y), cv::Point(box.x + box.width, box.y + box.height), 
-                          cv::Scalar(0, 0, 255), 2);
-          }
-          // Display performance information.
-          std::vector<double> layersTimes;
-          double freq = cv::getTickFrequency() / 1000;
-          double t = net.getPerfProfile(layersTimes) / freq;
-          std::string label = cv::format("Inference time for a frame : %.2f ms", t);
-          cv::putText(img, label, cv::Point(0, 15), cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(0, 0, 255));
-
-          cv::imshow("Kiwi detection", img);
-          cv::waitKey(1);
-<<<<<<< HEAD
-        }
+      Od4Bus od4{static_cast<uint16_t>(std::stoi(commandlineArguments["cid"])), SHM_BUS, UDP_BATCH};
 
-=======
-        } 
-
-        // send out the detection(s)
->>>>>>> 8dad46f475c6e434051cd4f6f534a2460f016110
-        opendlv::perception::KiwiBoundingBox kiwi;
-        kiwi.imageWidth(WIDTH);
-        kiwi.imageHeight(HEIGHT);
-        kiwi.nBox(indices.size());
-
-        if (indices.size() == 0) {
-          kiwi.x(0);
-          kiwi.y(0);
-          kiwi.w(0);
-          kiwi.h(0);
-<<<<<<< HEAD
-
-=======
->>>>>>> 8dad46f475c6e434051cd4f6f534a2460f016110
-          cluon::data::TimeStamp sampleTime;
-          od4.send(kiwi, sampleTime, 0);
-        } else {
-          for (size_t i = 0; i < indices.size(); i++) {
-            uint32_t idx = indices[i];
-            cv::Rect box = boxes[idx];
-            kiwi.x(box.x);
-            kiwi.y(box.y);
-            kiwi.w(box.width);
-            kiwi.h(box.height);  
-            cluon::data::TimeStamp sampleTime;
-            od4.send(kiwi, sampleTime, 0);
-<<<<<<< HEAD
-
-=======
->>>>>>> 8dad46f475c6e434051cd4f6f534a2460f016110
-          }
-        }
+      // Messages from the frame loop and the publisher thread; the frame
+      // loop never waits for the log to be written.
+      AsyncLog log{argv[0]};
+      KiwiPublisher publisher{settings, od4, nullptr != halfMemory, kiwiMetrics, log};
+
+      if (settings.pipeline > 0) {
+        detectPipelined(settings, MODEL, *sharedMemory, halfMemory.get(), od4, sampler, kiwiMetrics, log, publisher, argv[0]);
+      } else {
+        SerialDetection serialDetection{settings, MODEL, kiwiMetrics, log};
+        serialDetection.warmUp();
+        reportReady(kiwiMetrics, argv[0]);
+        serialDetection.run(*sharedMemory, halfMemory.get(), od4, sampler, publisher);
       }
     }
     retCode = 0;
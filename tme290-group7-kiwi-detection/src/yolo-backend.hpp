@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YOLO_BACKEND_HPP
+#define YOLO_BACKEND_HPP
+
+#include "mapped-file.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/dnn/dnn.hpp>
+
+#ifdef HAVE_ONNXRUNTIME
+#include <onnxruntime_cxx_api.h>
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Where the Kiwi model comes from and what runs it.
+//   format:  "darknet" (configuration and weights) or "onnx" (weights is the
+//            .onnx file; FP32 or INT8 quantised)
+//   backend: "opencv" (OpenCV DNN on the CPU) or "onnxruntime" (ONNX
+//            Runtime on the CPU, for ONNX models, if built with it)
+// An ONNX model has to give the same outputs as the Darknet region layers
+// in OpenCV: one [rows, 5 + classes] matrix per head, with the boxes relative
+// to the input and the class scores multiplied by the objectness.
+struct KiwiModel {
+  std::string format{"darknet"};
+  std::string configuration{"/opt/yolo/yolo-obj.cfg"};
+  std::string weights{"/opt/yolo/yolo-obj.weights"};
+  std::string backend{"opencv"};
+
+  bool valid() const {
+    bool const isOnnx{format == "onnx"};
+#ifdef HAVE_ONNXRUNTIME
+    bool const hasOnnxRuntime{true};
+#else
+    bool const hasOnnxRuntime{false};
+#endif
+    return (format == "darknet" || isOnnx)
+      && (backend == "opencv" || (backend == "onnxruntime" && isOnnx && hasOnnxRuntime));
+  }
+
+  std::string name() const {
+    return format + "/" + backend + " " + weights;
+  }
+};
+
+// The model selected by --model-format, --model-config, --model-weights and
+// --model-backend; the format defaults to onnx for a .onnx file.
+inline KiwiModel kiwiModelFrom(std::map<std::string, std::string> &commandlineArguments) {
+  KiwiModel model;
+  if (commandlineArguments.count("model-weights") != 0) {
+    model.weights = commandlineArguments["model-weights"];
+    std::string const extension{".onnx"};
+    if (model.weights.size() > extension.size()
+        && model.weights.compare(model.weights.size() - extension.size(), extension.size(), extension) == 0) {
+      model.format = "onnx";
+    }
+  }
+  if (commandlineArguments.count("model-config") != 0) {
+    model.configuration = commandlineArguments["model-config"];
+  }
+  if (commandlineArguments.count("model-format") != 0) {
+    model.format = commandlineArguments["model-format"];
+  }
+  if (commandlineArguments.count("model-backend") != 0) {
+    model.backend = commandlineArguments["model-backend"];
+  }
+  return model;
+}
+
+// Runs the network on an NCHW blob (CV_8U or CV_32F), multiplied by scale,
+// and gives the outputs of the detection heads.
+class YoloBackend {
+ public:
+  virtual ~YoloBackend() = default;
+
+  virtual void forward(cv::Mat const &blob, double scale, std::vector<cv::Mat> &outs) = 0;
+
+  // Time of the last forward pass in milliseconds.
+  virtual double inferenceTime() = 0;
+};
+
+class OpenCvBackend : public YoloBackend {
+ private:
+  OpenCvBackend(OpenCvBackend const &) = delete;
+  OpenCvBackend(OpenCvBackend &&) = delete;
+  OpenCvBackend &operator=(OpenCvBackend const &) = delete;
+  OpenCvBackend &operator=(OpenCvBackend &&) = delete;
+
+ public:
+  explicit OpenCvBackend(KiwiModel const &model)
+    : m_net{readNet(model)}
+    , m_outNames{}
+  {
+    m_net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+    m_net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+    m_outNames = m_net.getUnconnectedOutLayersNames();
+  }
+
+  void forward(cv::Mat const &blob, double scale, std::vector<cv::Mat> &outs) override {
+    m_net.setInput(blob, "", scale, cv::Scalar(0,0,0));
+    m_net.forward(outs, m_outNames);
+  }
+
+  double inferenceTime() override {
+    std::vector<double> layersTimes;
+    double freq = cv::getTickFrequency() / 1000;
+    return m_net.getPerfProfile(layersTimes) / freq;
+  }
+
+ private:
+  // Parses the weights straight out of the mapped file, so they are not
+  // first read into a private buffer; the layers still get their own copy.
+  // Falls back to reading the files if they cannot be mapped.
+  static cv::dnn::Net readNet(KiwiModel const &model) {
+    MappedFile const weights{model.weights};
+    if (!weights.valid()) {
+      return (model.format == "onnx") ? cv::dnn::readNetFromONNX(model.weights) :
+        cv::dnn::readNetFromDarknet(model.configuration, model.weights);
+    }
+    if (model.format == "onnx") {
+      return cv::dnn::readNetFromONNX(weights.data(), weights.size());
+    }
+    std::ifstream file(model.configuration);
+    std::string const configuration{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    return cv::dnn::readNetFromDarknet(configuration.data(), configuration.size(), weights.data(), weights.size());
+  }
+
+  cv::dnn::Net m_net;
+  std::vector<cv::String> m_outNames;
+};
+
+#ifdef HAVE_ONNXRUNTIME
+// ONNX Runtime (1.13 or newer) on the CPU, with all graph optimisations.
+class OnnxRuntimeBackend : public YoloBackend {
+ private:
+  OnnxRuntimeBackend(OnnxRuntimeBackend const &) = delete;
+  OnnxRuntimeBackend(OnnxRuntimeBackend &&) = delete;
+  OnnxRuntimeBackend &operator=(OnnxRuntimeBackend const &) = delete;
+  OnnxRuntimeBackend &operator=(OnnxRuntimeBackend &&) = delete;
+
+ public:
+  explicit OnnxRuntimeBackend(KiwiModel const &model)
+    : m_env{ORT_LOGGING_LEVEL_WARNING, "kiwi-detection"}
+    , m_session{nullptr}
+    , m_inputName{}
+    , m_outputNames{}
+    , m_input{}
+    , m_inferenceTime{0.0}
+  {
+    Ort::SessionOptions options;
+    options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+    // As many workers as OpenCV may use (--threads), not one per core.
+    options.SetIntraOpNumThreads(cv::getNumThreads());
+    MappedFile const weights{model.weights};
+    if (weights.valid()) {
+      m_session = Ort::Session{m_env, weights.data(), weights.size(), options};
+    } else {
+      m_session = Ort::Session{m_env, model.weights.c_str(), options};
+    }
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    m_inputName = m_session.GetInputNameAllocated(0, allocator).get();
+    for (size_t i = 0; i < m_session.GetOutputCount(); i++) {
+      m_outputNames.push_back(m_session.GetOutputNameAllocated(i, allocator).get());
+    }
+  }
+
+  void forward(cv::Mat const &blob, double scale, std::vector<cv::Mat> &outs) override {
+    auto const start{std::chrono::steady_clock::now()};
+
+    // The session takes float input, normalised like OpenCV's setInput().
+    cv::Mat const *input = &blob;
+    if (blob.depth() != CV_32F || std::fabs(scale - 1.0) > 1e-9) {
+      blob.convertTo(m_input, CV_32F, scale);
+      input = &m_input;
+    }
+    std::vector<int64_t> shape;
+    for (int32_t i = 0; i < input->dims; i++) {
+      shape.push_back(input->size[i]);
+    }
+    Ort::MemoryInfo const memoryInfo{Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault)};
+    Ort::Value tensor{Ort::Value::CreateTensor<float>(memoryInfo, const_cast<float *>(input->ptr<float>()),
+        input->total(), shape.data(), shape.size())};
+
+    char const *inputNames[] = {m_inputName.c_str()};
+    std::vector<char const *> outputNames;
+    for (auto const &name : m_outputNames) {
+      outputNames.push_back(name.c_str());
+    }
+    std::vector<Ort::Value> results = m_session.Run(Ort::RunOptions{nullptr}, inputNames, &tensor, 1,
+        outputNames.data(), outputNames.size());
+
+    // As OpenCV: [rows, cols] for a single image, [batch, rows, cols]
+    // otherwise.
+    outs.clear();
+    for (auto &result : results) {
+      std::vector<int64_t> dims{result.GetTensorTypeAndShapeInfo().GetShape()};
+      if (dims.size() == 3 && dims[0] == 1) {
+        dims.erase(dims.begin());
+      }
+      std::vector<int32_t> sizes(dims.begin(), dims.end());
+      outs.push_back(cv::Mat(static_cast<int32_t>(sizes.size()), sizes.data(), CV_32F,
+            result.GetTensorMutableData<float>()).clone());
+    }
+
+    m_inferenceTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  double inferenceTime() override {
+    return m_inferenceTime;
+  }
+
+ private:
+  Ort::Env m_env;
+  Ort::Session m_session;
+  std::string m_inputName;
+  std::vector<std::string> m_outputNames;
+  cv::Mat m_input;
+  double m_inferenceTime;
+};
+#endif
+
+// Loads the model; throws for a model that is not valid() in this build.
+inline std::unique_ptr<YoloBackend> makeYoloBackend(KiwiModel const &model) {
+  if (!model.valid()) {
+    throw std::invalid_argument("Unsupported Kiwi model " + model.name());
+  }
+#ifdef HAVE_ONNXRUNTIME
+  if (model.backend == "onnxruntime") {
+    return std::unique_ptr<YoloBackend>{new OnnxRuntimeBackend{model}};
+  }
+#endif
+  return std::unique_ptr<YoloBackend>{new OpenCvBackend{model}};
+}
+
+#endif
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YOLO_DECODER_HPP
+#define YOLO_DECODER_HPP
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// Decoder for the region layer output of a YOLO head with one (or a few)
+// classes. Each output row is [x, y, w, h, objectness, class scores...],
+// relative to the frame. OpenCV already multiplies the class scores by the
+// objectness, so a row whose objectness is not above the threshold cannot
+// hold a detection. That column is scanned first and nearly every row stops
+// there; only the survivors are decoded, into preallocated arrays (one array
+// per field), and then pass a non maximum suppression bounded in both
+// candidates and detections.
+class YoloDecoder {
+ public:
+  YoloDecoder(float confThreshold, float nmsThreshold, size_t maxCandidates = 256, size_t maxDetections = 16)
+    : m_confThreshold{confThreshold}
+    , m_nmsThreshold{nmsThreshold}
+    , m_maxCandidates{maxCandidates}
+    , m_maxDetections{maxDetections}
+    , m_count{0}
+    , m_left(maxCandidates)
+    , m_top(maxCandidates)
+    , m_right(maxCandidates)
+    , m_bottom(maxCandidates)
+    , m_score(maxCandidates)
+    , m_order(maxCandidates)
+    , m_isSuppressed(maxCandidates)
+  {
+  }
+
+  // Starts a new image.
+  void reset() noexcept {
+    m_count = 0;
+  }
+
+  // Adds the candidates of one output layer ([rows, cols], CV_32F), with the
+  // boxes scaled to and clamped within frameSize.
+  void add(cv::Mat const &out, cv::Size const &frameSize) {
+    CV_Assert(out.type() == CV_32F && out.cols > 5 && out.isContinuous());
+    add(out.ptr<float>(), static_cast<size_t>(out.rows), static_cast<size_t>(out.cols), frameSize);
+  }
+
+  void add(float const *data, size_t rows, size_t cols, cv::Size const &frameSize) {
+    size_t row{0};
+#if CV_SIMD128
+    // The objectness is a strided column, so four rows are loaded per
+    // vector and a whole group is skipped when none is above the threshold.
+    cv::v_float32x4 const threshold = cv::v_setall_f32(m_confThreshold);
+    for (; row + 4 <= rows; row += 4) {
+      float const *p = data + row * cols + 4;
+      cv::v_float32x4 const objectness(p[0], p[cols], p[2 * cols], p[3 * cols]);
+      int32_t const mask{cv::v_signmask(objectness > threshold)};
+      for (size_t i = 0; i < 4; i++) {
+        if (mask & (1 << i)) {
+          candidate(data + (row + i) * cols, cols, frameSize);
+        }
+      }
+    }
+#endif
+    for (; row < rows; row++) {
+      if (data[row * cols + 4] > m_confThreshold) {
+        candidate(data + row * cols, cols, frameSize);
+      }
+    }
+  }
+
+  // Non maximum suppression over the candidates of the image, strongest
+  // first.
+  std::vector<cv::Rect> finish() {
+    std::vector<cv::Rect> detections;
+    std::iota(m_order.begin(), m_order.begin() + static_cast<std::ptrdiff_t>(m_count), size_t{0});
+    std::sort(m_order.begin(), m_order.begin() + static_cast<std::ptrdiff_t>(m_count),
+        [this](size_t a, size_t b) { return m_score[a] > m_score[b]; });
+    std::fill(m_isSuppressed.begin(), m_isSuppressed.begin() + static_cast<std::ptrdiff_t>(m_count), false);
+
+    for (size_t i = 0; i < m_count && detections.size() < m_maxDetections; i++) {
+      size_t const a{m_order[i]};
+      if (m_isSuppressed[a]) {
+        continue;
+      }
+      detections.push_back(cv::Rect(static_cast<int32_t>(m_left[a]), static_cast<int32_t>(m_top[a]),
+            static_cast<int32_t>(m_right[a] - m_left[a]), static_cast<int32_t>(m_bottom[a] - m_top[a])));
+      for (size_t j = i + 1; j < m_count; j++) {
+        size_t const b{m_order[j]};
+        if (!m_isSuppressed[b] && overlap(a, b) > m_nmsThreshold) {
+          m_isSuppressed[b] = true;
+        }
+      }
+    }
+    return detections;
+  }
+
+ private:
+  void candidate(float const *row, size_t cols, cv::Size const &frameSize) {
+    float score{row[5]};
+    for (size_t c = 6; c < cols; c++) {
+      score = std::max(score, row[c]);
+    }
+    if (score <= m_confThreshold) {
+      return;
+    }
+
+    // When full, the weakest candidate gives way.
+    size_t slot{m_count};
+    if (m_count == m_maxCandidates) {
+      slot = static_cast<size_t>(std::min_element(m_score.begin(), m_score.end()) - m_score.begin());
+      if (m_score[slot] >= score) {
+        return;
+      }
+    } else {
+      m_count++;
+    }
+
+    float const width{static_cast<float>(frameSize.width)};
+    float const height{static_cast<float>(frameSize.height)};
+    float const halfW{0.5f * row[2] * width};
+    float const halfH{0.5f * row[3] * height};
+    float const centerX{row[0] * width};
+    float const centerY{row[1] * height};
+    m_left[slot] = std::min(std::max(centerX - halfW, 0.0f), width);
+    m_top[slot] = std::min(std::max(centerY - halfH, 0.0f), height);
+    m_right[slot] = std::min(std::max(centerX + halfW, 0.0f), width);
+    m_bottom[slot] = std::min(std::max(centerY + halfH, 0.0f), height);
+    m_score[slot] = score;
+  }
+
+  float overlap(size_t a, size_t b) const noexcept {
+    float const w{std::min(m_right[a], m_right[b]) - std::max(m_left[a], m_left[b])};
+    float const h{std::min(m_bottom[a], m_bottom[b]) - std::max(m_top[a], m_top[b])};
+    if (w <= 0.0f || h <= 0.0f) {
+      return 0.0f;
+    }
+    float const intersection{w * h};
+    float const areaA{(m_right[a] - m_left[a]) * (m_bottom[a] - m_top[a])};
+    float const areaB{(m_right[b] - m_left[b]) * (m_bottom[b] - m_top[b])};
+    return intersection / (areaA + areaB - intersection);
+  }
+
+  float const m_confThreshold;
+  float const m_nmsThreshold;
+  size_t const m_maxCandidates;
+  size_t const m_maxDetections;
+  size_t m_count;
+  std::vector<float> m_left;
+  std::vector<float> m_top;
+  std::vector<float> m_right;
+  std::vector<float> m_bottom;
+  std::vector<float> m_score;
+  std::vector<size_t> m_order;
+  std::vector<bool> m_isSuppressed;
+};
+
+#endif
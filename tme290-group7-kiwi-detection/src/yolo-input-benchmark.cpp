@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "yolo-input.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/dnn/dnn.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Compares the fused network input with the chain it replaces, on a random
+// frame of the camera's size.
+int32_t main(int32_t argc, char **argv) {
+  uint32_t const WIDTH{(argc > 1) ? static_cast<uint32_t>(std::stoi(argv[1])) : 1280};
+  uint32_t const HEIGHT{(argc > 2) ? static_cast<uint32_t>(std::stoi(argv[2])) : 720};
+  uint32_t const SIZE{(argc > 3) ? static_cast<uint32_t>(std::stoi(argv[3])) : 320};
+  uint32_t const ITERATIONS{(argc > 4) ? static_cast<uint32_t>(std::stoi(argv[4])) : 500};
+
+  cv::Mat frame(HEIGHT, WIDTH, CV_8UC4);
+  cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(256));
+  cv::Size const inputSize(SIZE, SIZE);
+
+  // What the network receives after setInput(blob, "", 1/255).
+  auto chain{[&frame, &inputSize]() {
+      cv::Mat imga = frame.clone();
+      cv::Mat img;
+      cv::cvtColor(imga, img, cv::COLOR_RGBA2RGB);
+      cv::Mat blob;
+      cv::dnn::blobFromImage(img, blob, 1.0, inputSize, cv::Scalar(), false, false, CV_8U);
+      cv::Mat input;
+      blob.convertTo(input, CV_32F, 1.0/255.0);
+      return input;
+    }};
+
+  YoloInput const yoloInput{frame.size(), inputSize};
+  cv::Mat tensor;
+  std::vector<float> rowBuffer;
+  auto fused{[&frame, &yoloInput, &tensor, &rowBuffer]() {
+      yoloInput.run(frame, tensor, rowBuffer);
+      return tensor;
+    }};
+
+  auto measure{[ITERATIONS](auto &&f) {
+      f();
+      auto const start = std::chrono::steady_clock::now();
+      for (uint32_t i = 0; i < ITERATIONS; i++) {
+        f();
+      }
+      auto const stop = std::chrono::steady_clock::now();
+      return std::chrono::duration<double, std::milli>(stop - start).count() / ITERATIONS;
+    }};
+
+  double const chainTime{measure(chain)};
+  double const fusedTime{measure(fused)};
+
+  cv::Mat const reference = chain();
+  cv::Mat const result = fused().clone();
+  double const maxError{cv::norm(reference.reshape(1, 1), result.reshape(1, 1), cv::NORM_INF)};
+
+  std::cout << WIDTH << "x" << HEIGHT << " BGRA -> 1x3x" << SIZE << "x" << SIZE << " float, "
+    << ITERATIONS << " iterations" << std::endl;
+  std::cout << "  clone+cvtColor+blobFromImage+scale: " << chainTime << " ms" << std::endl;
+  std::cout << "  fused:                              " << fusedTime << " ms" << std::endl;
+  std::cout << "  largest difference:                 " << maxError << " (" << maxError * 255.0 << " grey levels)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef YOLO_INPUT_HPP
+#define YOLO_INPUT_HPP
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Turns a BGRA frame into the network input in one pass: bilinear resize to
+// the input size, alpha dropped, scaled by 1/255 and written as a planar
+// float NCHW tensor (1 x 3 x h x w). It replaces the chain
+//   clone -> cvtColor(RGBA2RGB) -> blobFromImage(CV_8U) -> setInput(1/255)
+// and keeps its channel order (B, G, R, as the network was trained on).
+//
+// The taps follow the half-pixel convention of cv::resize(INTER_LINEAR), but
+// are kept in float instead of OpenCV's 11 bit fixed point, so the values can
+// differ from the old chain by about one step of 1/255.
+//
+// Optionally, only a part of the frame (source) is used. It is then
+// letterboxed: scaled to fit the input with its aspect kept, centred, and
+// the rest of the input is set to grey (0.5) as in Darknet.
+//
+// The taps only depend on the sizes, so one instance may be shared by
+// several threads as long as each writes into its own tensor and row buffer.
+class YoloInput {
+ public:
+  YoloInput(cv::Size const &frameSize, cv::Size const &inputSize)
+    : YoloInput(frameSize, inputSize, cv::Rect(cv::Point(0, 0), frameSize), cv::Rect(cv::Point(0, 0), inputSize))
+  {
+  }
+
+  YoloInput(cv::Size const &frameSize, cv::Size const &inputSize, cv::Rect const &source)
+    : YoloInput(frameSize, inputSize, source, letterbox(source.size(), inputSize))
+  {
+  }
+
+  cv::Size inputSize() const noexcept {
+    return m_inputSize;
+  }
+
+  // The size to decode the network output to (KiwiDetector::detectBlob) so
+  // that toFrame() can move the boxes into the frame.
+  cv::Size decodeSize() const noexcept {
+    return cv::Size(static_cast<int32_t>(std::lround(static_cast<double>(m_inputSize.width) * m_source.width / m_target.width)),
+        static_cast<int32_t>(std::lround(static_cast<double>(m_inputSize.height) * m_source.height / m_target.height)));
+  }
+
+  // Moves boxes decoded at decodeSize() into frame pixels, clipped to the
+  // source.
+  std::vector<cv::Rect> toFrame(std::vector<cv::Rect> const &boxes) const {
+    cv::Size const size{decodeSize()};
+    cv::Point const offset(m_source.x - (size.width - m_source.width) / 2,
+        m_source.y - (size.height - m_source.height) / 2);
+    std::vector<cv::Rect> result;
+    for (auto const &box : boxes) {
+      cv::Rect const moved{(box + offset) & m_source};
+      if (moved.area() > 0) {
+        result.push_back(moved);
+      }
+    }
+    return result;
+  }
+
+  // Reads the BGRA frame (for example straight from the shared memory) and
+  // writes the tensor. The tensor is only allocated if it does not already
+  // have the right shape, and the row buffer (scratch for the resampled
+  // rows) only if it is too small, so passing the same ones each frame
+  // reuses them.
+  void run(cv::Mat const &bgra, cv::Mat &tensor, std::vector<float> &rowBuffer) const {
+    CV_Assert(bgra.type() == CV_8UC4 && bgra.size() == m_frameSize);
+    int32_t const shape[] = {1, 3, m_inputSize.height, m_inputSize.width};
+    tensor.create(4, shape, CV_32F);
+
+    size_t const inputWidth{static_cast<size_t>(m_inputSize.width)};
+    size_t const planeSize{inputWidth * static_cast<size_t>(m_inputSize.height)};
+    size_t const w{static_cast<size_t>(m_target.width)};
+    float *planes = tensor.ptr<float>();
+
+    // The letterbox borders.
+    float constexpr grey{0.5f};
+    for (size_t y = 0; y < static_cast<size_t>(m_inputSize.height); y++) {
+      bool const isBorderRow{static_cast<int32_t>(y) < m_target.y || static_cast<int32_t>(y) >= m_target.y + m_target.height};
+      for (size_t c = 0; c < 3; c++) {
+        float *row = planes + c * planeSize + y * inputWidth;
+        if (isBorderRow) {
+          std::fill(row, row + inputWidth, grey);
+        } else {
+          std::fill(row, row + m_target.x, grey);
+          std::fill(row + m_target.x + m_target.width, row + inputWidth, grey);
+        }
+      }
+    }
+
+    // Horizontally resampled (and normalised) source rows, planar. Two rows
+    // are kept, as consecutive output rows mostly share their source rows.
+    if (rowBuffer.size() < 6 * w) {
+      rowBuffer.resize(6 * w);
+    }
+    float *rows[2] = {rowBuffer.data(), rowBuffer.data() + 3 * w};
+    int32_t rowIndex[2] = {-1, -1};
+    size_t const firstPixel{static_cast<size_t>(m_target.y) * inputWidth + static_cast<size_t>(m_target.x)};
+
+    for (size_t y = 0; y < static_cast<size_t>(m_target.height); y++) {
+      int32_t const r0{m_yRow0[y]};
+      int32_t const r1{m_yRow1[y]};
+      if (rowIndex[0] != r0) {
+        if (rowIndex[1] == r0) {
+          std::swap(rows[0], rows[1]);
+          std::swap(rowIndex[0], rowIndex[1]);
+        } else {
+          horizontal(bgra.ptr<uint8_t>(r0), rows[0]);
+          rowIndex[0] = r0;
+        }
+      }
+      if (rowIndex[1] != r1) {
+        horizontal(bgra.ptr<uint8_t>(r1), rows[1]);
+        rowIndex[1] = r1;
+      }
+
+      float const fy{m_yWeight[y]};
+      for (size_t c = 0; c < 3; c++) {
+        vertical(rows[0] + c * w, rows[1] + c * w, fy, planes + c * planeSize + firstPixel + y * inputWidth, w);
+      }
+    }
+  }
+
+ private:
+  YoloInput(cv::Size const &frameSize, cv::Size const &inputSize, cv::Rect const &source, cv::Rect const &target)
+    : m_frameSize{frameSize}
+    , m_inputSize{inputSize}
+    , m_source{source}
+    , m_target{target}
+    , m_xOffset0(static_cast<size_t>(target.width))
+    , m_xOffset1(static_cast<size_t>(target.width))
+    , m_xWeight(static_cast<size_t>(target.width))
+    , m_yRow0(static_cast<size_t>(target.height))
+    , m_yRow1(static_cast<size_t>(target.height))
+    , m_yWeight(static_cast<size_t>(target.height))
+  {
+    CV_Assert((source & cv::Rect(cv::Point(0, 0), frameSize)) == source
+        && (target & cv::Rect(cv::Point(0, 0), inputSize)) == target && target.area() > 0);
+    taps(source.x, source.width, target.width, m_xOffset0, m_xOffset1, m_xWeight);
+    taps(source.y, source.height, target.height, m_yRow0, m_yRow1, m_yWeight);
+    // Byte offsets of the BGRA pixels.
+    for (size_t i = 0; i < m_xOffset0.size(); i++) {
+      m_xOffset0[i] *= 4;
+      m_xOffset1[i] *= 4;
+    }
+  }
+
+  // The largest centred rectangle within the input with the aspect of the
+  // source.
+  static cv::Rect letterbox(cv::Size const &source, cv::Size const &inputSize) {
+    double const scale{std::min(static_cast<double>(inputSize.width) / source.width,
+        static_cast<double>(inputSize.height) / source.height)};
+    int32_t const width{std::min(static_cast<int32_t>(std::lround(source.width * scale)), inputSize.width)};
+    int32_t const height{std::min(static_cast<int32_t>(std::lround(source.height * scale)), inputSize.height)};
+    return cv::Rect((inputSize.width - width) / 2, (inputSize.height - height) / 2, width, height);
+  }
+
+  // Source index pairs (starting at srcStart) and weights for each
+  // destination index, as in cv::resize: sx = (dx + 0.5) * scale - 0.5,
+  // clamped at the borders.
+  static void taps(int32_t srcStart, int32_t srcSize, int32_t dstSize, std::vector<int32_t> &index0,
+      std::vector<int32_t> &index1, std::vector<float> &weight) {
+    double const scale{static_cast<double>(srcSize) / dstSize};
+    for (int32_t d = 0; d < dstSize; d++) {
+      double const s{(d + 0.5) * scale - 0.5};
+      int32_t i0{static_cast<int32_t>(std::floor(s))};
+      float f{static_cast<float>(s - i0)};
+      if (i0 < 0) {
+        i0 = 0;
+        f = 0.0f;
+      }
+      if (i0 >= srcSize - 1) {
+        i0 = srcSize - 1;
+        f = 0.0f;
+      }
+      index0[static_cast<size_t>(d)] = srcStart + i0;
+      index1[static_cast<size_t>(d)] = srcStart + std::min(i0 + 1, srcSize - 1);
+      weight[static_cast<size_t>(d)] = f;
+    }
+  }
+
+  // Gathers one source row into three planar float rows, scaled to [0, 1].
+  void horizontal(uint8_t const *src, float *dst) const {
+    size_t const w{m_xOffset0.size()};
+    float constexpr norm{1.0f / 255.0f};
+    float *b = dst;
+    float *g = dst + w;
+    float *r = dst + 2 * w;
+    for (size_t x = 0; x < w; x++) {
+      uint8_t const *p0 = src + m_xOffset0[x];
+      uint8_t const *p1 = src + m_xOffset1[x];
+      float const fx{m_xWeight[x]};
+      b[x] = (p0[0] + fx * (p1[0] - p0[0])) * norm;
+      g[x] = (p0[1] + fx * (p1[1] - p0[1])) * norm;
+      r[x] = (p0[2] + fx * (p1[2] - p0[2])) * norm;
+    }
+  }
+
+  // dst = top + fy * (bottom - top), four lanes at a time where available.
+  static void vertical(float const *top, float const *bottom, float fy, float *dst, size_t w) {
+    size_t x{0};
+#if CV_SIMD128
+    cv::v_float32x4 const vfy = cv::v_setall_f32(fy);
+    for (; x + 4 <= w; x += 4) {
+      cv::v_float32x4 const t = cv::v_load(top + x);
+      cv::v_float32x4 const b = cv::v_load(bottom + x);
+      cv::v_store(dst + x, cv::v_muladd(b - t, vfy, t));
+    }
+#endif
+    for (; x < w; x++) {
+      dst[x] = top[x] + fy * (bottom[x] - top[x]);
+    }
+  }
+
+  cv::Size const m_frameSize;
+  cv::Size const m_inputSize;
+  cv::Rect const m_source;
+  cv::Rect const m_target;
+  std::vector<int32_t> m_xOffset0;
+  std::vector<int32_t> m_xOffset1;
+  std::vector<float> m_xWeight;
+  std::vector<int32_t> m_yRow0;
+  std::vector<int32_t> m_yRow1;
+  std::vector<float> m_yWeight;
+};
+
+#endif
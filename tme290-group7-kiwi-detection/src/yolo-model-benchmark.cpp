@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kiwi-detector.hpp"
+#include "process-stats.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgcodecs/imgcodecs.hpp>
+
+#include <malloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// format,backend,weights[,configuration]
+static KiwiModel parseModel(std::string const &variant) {
+  std::vector<std::string> fields;
+  std::stringstream sstr(variant);
+  std::string field;
+  while (std::getline(sstr, field, ',')) {
+    fields.push_back(field);
+  }
+  KiwiModel model;
+  model.format = (fields.size() > 0) ? fields[0] : "";
+  model.backend = (fields.size() > 1) ? fields[1] : "";
+  model.weights = (fields.size() > 2) ? fields[2] : "";
+  model.configuration = (fields.size() > 3) ? fields[3] : "";
+  return model;
+}
+
+// Boxes of a variant that overlap a box of the baseline by at least half
+// (each baseline box matched once), and their mean overlap.
+static uint32_t matchBoxes(std::vector<cv::Rect> const &baseline, std::vector<cv::Rect> const &boxes, double &overlapSum) {
+  std::vector<bool> isUsed(baseline.size(), false);
+  uint32_t matches{0};
+  for (auto const &box : boxes) {
+    double best{0.5};
+    size_t bestIndex{baseline.size()};
+    for (size_t i = 0; i < baseline.size(); i++) {
+      double const intersection{static_cast<double>((box & baseline[i]).area())};
+      double const overlap{intersection / (box.area() + baseline[i].area() - intersection)};
+      if (!isUsed[i] && overlap >= best) {
+        best = overlap;
+        bestIndex = i;
+      }
+    }
+    if (bestIndex < baseline.size()) {
+      isUsed[bestIndex] = true;
+      overlapSum += best;
+      matches++;
+    }
+  }
+  return matches;
+}
+
+// Runs each model variant over a set of recorded frames and compares it with
+// the first variant (the FP32 Darknet model that is shipped).
+int32_t main(int32_t argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << argv[0] << " runs Kiwi model variants over a set of frames and compares them with the first variant." << std::endl;
+    std::cerr << "Usage:   " << argv[0] << " <directory with .png/.jpg frames> <input size> [<format>,<backend>,<weights>[,<configuration>] ...]" << std::endl;
+    std::cerr << "Example: " << argv[0] << " frames 320 darknet,opencv,/opt/yolo/yolo-obj.weights,/opt/yolo/yolo-obj.cfg "
+      << "onnx,opencv,yolo-obj.onnx onnx,opencv,yolo-obj-int8.onnx onnx,onnxruntime,yolo-obj-int8.onnx" << std::endl;
+    return 1;
+  }
+  int32_t const SIZE{std::stoi(argv[2])};
+
+  std::vector<cv::String> files;
+  std::vector<cv::String> jpgs;
+  cv::glob(std::string{argv[1]} + "/*.png", files);
+  cv::glob(std::string{argv[1]} + "/*.jpg", jpgs);
+  files.insert(files.end(), jpgs.begin(), jpgs.end());
+  std::vector<cv::Mat> frames;
+  for (auto const &file : files) {
+    cv::Mat frame{cv::imread(file, cv::IMREAD_COLOR)};
+    if (!frame.empty()) {
+      frames.push_back(frame);
+    }
+  }
+  if (frames.empty()) {
+    std::cerr << argv[0] << ": No frames in " << argv[1] << "." << std::endl;
+    return 1;
+  }
+
+  std::vector<KiwiModel> models;
+  if (argc == 3) {
+    models.push_back(KiwiModel{});
+  }
+  for (int32_t i = 3; i < argc; i++) {
+    models.push_back(parseModel(argv[i]));
+  }
+
+  std::cout << frames.size() << " frames, " << SIZE << "x" << SIZE << " input" << std::endl;
+  std::vector<std::vector<cv::Rect>> baseline;
+  for (auto const &model : models) {
+    if (!model.valid()) {
+      std::cout << model.name() << ": not supported by this build" << std::endl;
+      continue;
+    }
+
+    std::vector<double> times;
+    std::vector<std::vector<cv::Rect>> detections;
+    uint64_t memory{0};
+    double loadTime{0.0};
+    {
+      uint64_t const memoryBefore{residentMemory()};
+      auto const start{std::chrono::steady_clock::now()};
+      KiwiDetector kiwiDetector{model, cv::Size(SIZE, SIZE)};
+      kiwiDetector.detectPrepared(frames.front(), frames.front().size());
+      loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      uint64_t const memoryAfter{residentMemory()};
+      memory = (memoryAfter > memoryBefore) ? memoryAfter - memoryBefore : 0;
+
+      for (auto const &frame : frames) {
+        auto const frameStart{std::chrono::steady_clock::now()};
+        detections.push_back(kiwiDetector.detectPrepared(frame, frame.size()));
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+      }
+    }
+    // Hand the memory of the variant back, so that the next one is measured
+    // from the same level.
+    malloc_trim(0);
+
+    if (baseline.empty()) {
+      baseline = detections;
+    }
+    uint32_t baselineBoxes{0};
+    uint32_t boxes{0};
+    uint32_t matches{0};
+    double overlapSum{0.0};
+    for (size_t i = 0; i < frames.size(); i++) {
+      baselineBoxes += static_cast<uint32_t>(baseline[i].size());
+      boxes += static_cast<uint32_t>(detections[i].size());
+      matches += matchBoxes(baseline[i], detections[i], overlapSum);
+    }
+
+    std::sort(times.begin(), times.end());
+    double sum{0.0};
+    for (double t : times) {
+      sum += t;
+    }
+    std::cout << std::fixed << std::setprecision(2) << model.name() << std::endl
+      << "  latency:   mean " << sum / times.size() << " ms, median " << times[times.size() / 2]
+      << " ms, 95th percentile " << times[times.size() * 95 / 100] << " ms" << std::endl
+      << "  memory:    " << memory / 1024.0 << " MB resident, loaded in " << loadTime << " ms" << std::endl
+      << "  agreement: " << matches << " of " << baselineBoxes << " baseline boxes found, "
+      << (boxes - matches) << " extra, mean overlap " << ((matches > 0) ? overlapSum / matches : 0.0) << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOGIC_CONTROLLER_HPP
+#define LOGIC_CONTROLLER_HPP
+
+#include "opendlv-standard-message-set.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+// The control logic for the kiwi car: lateral control towards the near and
+// far points of the track and longitudinal control behind other Kiwis and at
+// crossings. The controller keeps the state of the previous step. It does
+// no output itself; the caller logs from isFollowingKiwi().
+class LogicController {
+ public:
+  LogicController() noexcept
+    : m_previousCrossProduct{}
+    , m_previousNearX{}
+    , m_previousNearY{}
+    , m_previousGroundSteeringRequest{}
+    , m_previousPedalPositionRequest{}
+    , m_isFollowingKiwi{false}
+  {
+  }
+
+  std::pair<opendlv::proxy::GroundSteeringRequest, opendlv::proxy::PedalPositionRequest> step(
+      opendlv::perception::cognition::NearFarPoints const &nfPointsReading,
+      opendlv::perception::KiwiBoundingBox const &kiwiBoundingBox) {
+    int32_t previousNearX = m_previousNearX;
+    int32_t previousNearY = m_previousNearY;
+    int32_t nearX = nfPointsReading.nearX();
+    int32_t nearY = nfPointsReading.nearY();
+    int32_t farX = nfPointsReading.farX();
+    int32_t farY = nfPointsReading.farY();
+    bool reachCrossRoad = nfPointsReading.reachCrossRoad();
+
+    // use a simple KF to estimate the near point
+    {
+      float ks = 600.0f;  // vehicle speed to displacement vector length
+      float ka = 1.0f;  // steering angle to displacement vector angle
+      float motionVectorLength = ks * m_previousPedalPositionRequest.position();
+      float motionVectorAngle = ka * m_previousGroundSteeringRequest.groundSteering();
+      int32_t predictedNearX = previousNearX - static_cast<int32_t>(motionVectorLength*cos(motionVectorAngle));
+      int32_t predictedNearY = previousNearY - static_cast<int32_t>(motionVectorLength*sin(motionVectorAngle));
+
+      float g = 0.65f;
+      nearX = static_cast<int32_t>(g * nearX + (1.0f-g) * predictedNearX);
+      nearY = static_cast<int32_t>(g * nearY + (1.0f-g) * predictedNearY);
+
+      m_previousNearX = nearX;
+      m_previousNearY = nearY;
+    }
+
+    // controller parameters
+    float kp = 0.20f;
+    float kd = 0.05f;
+
+    float desiredVectorX = (farX + 2*nearX)/2;
+    float desiredVectorY = (farY + 2*nearY)/2;
+    float desiredVectorLength = std::sqrt(desiredVectorX*desiredVectorX + desiredVectorY*desiredVectorY);
+
+    // deal with the NaN value when desiredVectorLength == 0
+    if (desiredVectorLength < 0.01f) {
+        desiredVectorLength = 1.0f;
+    }
+
+    float crossProductZ =  1.0f * desiredVectorY/desiredVectorLength - 0.0f * desiredVectorX/desiredVectorLength;
+    float dotProductZ =  1.0f * desiredVectorX/desiredVectorLength - 0.0f * desiredVectorY/desiredVectorLength;
+
+    float pedalPosition = 0.2f;
+    m_isFollowingKiwi = false;
+    float groundSteeringAngle = 0.0f;
+
+    // lateral control
+    float previousCrossProduct = m_previousCrossProduct;
+    if (farX == 0 && nearX == 0) {
+      groundSteeringAngle = 0.0f;
+    } else if (dotProductZ < 0.0f) {
+      groundSteeringAngle = kp * ((crossProductZ<0.0f)?-1.0f:1.0f) + kd*(crossProductZ-previousCrossProduct);
+    } else {
+      groundSteeringAngle = kp*crossProductZ + kd*(crossProductZ-previousCrossProduct);
+    }
+    m_previousCrossProduct = crossProductZ;
+
+    // slow down when a big turn is required
+    pedalPosition = 0.10f*(1.0f - ((groundSteeringAngle<0)?-1.0f:1.0f)*(groundSteeringAngle));
+
+    // longitudinal control (slow down behind Kiwis and at crossings)
+    if (kiwiBoundingBox.nBox() > 0) {
+      uint32_t boxX = kiwiBoundingBox.x();
+      uint32_t boxY = kiwiBoundingBox.y();
+      uint32_t boxW = kiwiBoundingBox.w();
+      uint32_t boxH = kiwiBoundingBox.h();
+      float boxSize = static_cast<float>(boxW * boxH);
+      uint32_t imgW = kiwiBoundingBox.imageWidth();
+      uint32_t imgH = kiwiBoundingBox.imageHeight();
+      float imgSize =  static_cast<float>(imgW*imgH);
+      float maxKiwiSizeAllowed = imgSize/10;
+      if (boxSize > imgSize/100 && fabs(crossProductZ) < 0.15) {
+         pedalPosition = 0.2f*(1.0f - boxSize/maxKiwiSizeAllowed);
+         m_isFollowingKiwi = true;
+         //if (boxSize > maxKiwiSizeAllowed) {
+         //  pedalPosition = 0.0f;
+         //}
+      }
+      if (reachCrossRoad && pedalPosition>0.04f) {
+        pedalPosition = 0.04f;
+      }
+      if (boxY!=imgH-1 && reachCrossRoad && boxX+boxW > imgW/2-1 && boxSize > imgSize/20) {
+        pedalPosition = 0.0f;
+      } 
+     }
+
+    opendlv::proxy::GroundSteeringRequest groundSteeringRequest;
+    groundSteeringRequest.groundSteering(groundSteeringAngle);
+
+    opendlv::proxy::PedalPositionRequest pedalPositionRequest;
+    pedalPositionRequest.position(pedalPosition);
+
+    m_previousGroundSteeringRequest = groundSteeringRequest;
+    m_previousPedalPositionRequest = pedalPositionRequest;
+
+    return std::make_pair(groundSteeringRequest, pedalPositionRequest);
+  }
+
+  // Whether the last step slowed down for a Kiwi ahead.
+  bool isFollowingKiwi() const noexcept {
+    return m_isFollowingKiwi;
+  }
+
+ private:
+  float m_previousCrossProduct;
+  int32_t m_previousNearX;
+  int32_t m_previousNearY;
+  opendlv::proxy::GroundSteeringRequest m_previousGroundSteeringRequest;
+  opendlv::proxy::PedalPositionRequest m_previousPedalPositionRequest;
+  bool m_isFollowingKiwi;
+};
+
+#endif
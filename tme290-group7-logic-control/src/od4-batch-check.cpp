@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cluon-complete.hpp"
+#include "opendlv-standard-message-set.hpp"
+#include "od4-bus.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+static std::string hex(std::string const &bytes) {
+  std::string text;
+  char digits[4];
+  for (char c : bytes) {
+    std::snprintf(digits, sizeof(digits), "%02x ", static_cast<uint8_t>(c));
+    text += digits;
+  }
+  return text;
+}
+
+static cluon::data::TimeStamp timeStamp(int32_t seconds, int32_t microseconds) {
+  cluon::data::TimeStamp timeStamp;
+  timeStamp.seconds(seconds).microseconds(microseconds);
+  return timeStamp;
+}
+
+// Encodes the message into an envelope as Od4Batch does, and as cluon does,
+// for each pair of time stamps and each sender stamp. Prints the envelopes
+// that differ and gives their number.
+template <typename T>
+static uint32_t check(std::string const &name, T message) {
+  std::vector<cluon::data::TimeStamp> const TIME_STAMPS{timeStamp(0, 0), timeStamp(1, 1),
+    timeStamp(1600000000, 999999), timeStamp(std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max()),
+    timeStamp(-1, -1), timeStamp(std::numeric_limits<int32_t>::min(), -999999)};
+  std::vector<uint32_t> const SENDER_STAMPS{0, 1, 127, 128, 16384, std::numeric_limits<uint32_t>::max()};
+
+  uint32_t failures{0};
+  std::string payload;
+  od4bus::appendMessage(payload, message);
+  cluon::ToProtoVisitor proto;
+  message.accept(proto);
+  std::string encoded;
+  for (auto const &sent : TIME_STAMPS) {
+    for (auto const &sampleTime : TIME_STAMPS) {
+      for (uint32_t senderStamp : SENDER_STAMPS) {
+        od4bus::encodeEnvelope(encoded, static_cast<int32_t>(T::ID()), payload, sent, sampleTime, senderStamp);
+
+        cluon::data::Envelope envelope;
+        envelope.dataType(static_cast<int32_t>(T::ID())).serializedData(proto.encodedData())
+          .sent(sent).sampleTimeStamp(sampleTime).senderStamp(senderStamp);
+        std::string const expected{cluon::serializeEnvelope(std::move(envelope))};
+
+        size_t envelopeSize{0};
+        int32_t dataType{0};
+        bool const isPeeked{od4bus::peekEnvelope(encoded.data(), encoded.size(), envelopeSize, dataType)
+          && envelopeSize == encoded.size() && dataType == static_cast<int32_t>(T::ID())};
+        if (encoded != expected || !isPeeked) {
+          if (failures == 0) {
+            std::cerr << name << " (sent " << sent.seconds() << "." << sent.microseconds() << ", sample "
+              << sampleTime.seconds() << "." << sampleTime.microseconds() << ", sender " << senderStamp << "):" << std::endl
+              << "  od4bus: " << hex(encoded) << std::endl
+              << "  cluon:  " << hex(expected) << std::endl;
+          }
+          failures++;
+        }
+      }
+    }
+  }
+  if (failures > 0) {
+    std::cerr << name << ": " << failures << " envelope(s) differ." << std::endl;
+  }
+  return failures;
+}
+
+// Checks that the envelopes Od4Batch encodes from the precomputed layouts
+// are byte for byte the ones cluon::serializeEnvelope gives, for the
+// messages the services send, with negative and large values in every
+// varint. Exits with 1 if any differ.
+int32_t main() {
+  uint32_t failures{0};
+
+  opendlv::proxy::GroundSteeringRequest steering;
+  failures += check("GroundSteeringRequest 0", steering);
+  steering.groundSteering(-0.5f);
+  failures += check("GroundSteeringRequest -0.5", steering);
+
+  opendlv::proxy::PedalPositionRequest pedal;
+  pedal.position(std::numeric_limits<float>::max());
+  failures += check("PedalPositionRequest max", pedal);
+
+  opendlv::proxy::SwitchStateReading state;
+  state.state(std::numeric_limits<int16_t>::min());
+  failures += check("SwitchStateReading min", state);
+  state.state(std::numeric_limits<int16_t>::max());
+  failures += check("SwitchStateReading max", state);
+
+  opendlv::perception::cognition::NearFarPoints points;
+  failures += check("NearFarPoints 0", points);
+  points.nearX(std::numeric_limits<int32_t>::min()).nearY(-1).farX(std::numeric_limits<int32_t>::max()).farY(64)
+    .reachCrossRoad(true);
+  failures += check("NearFarPoints extremes", points);
+
+  opendlv::perception::KiwiBoundingBox box;
+  box.x(std::numeric_limits<uint32_t>::max()).y(128).w(16383).h(16384).imageWidth(1280).imageHeight(720)
+    .nBox(1).predicted(true).age(std::numeric_limits<uint32_t>::max());
+  failures += check("KiwiBoundingBox", box);
+
+  // Not of scalar fields only, so it goes through the visitor.
+  opendlv::perception::KiwiBoundingBoxArray boxes;
+  boxes.frameId(std::numeric_limits<uint32_t>::max()).sampleTime(std::numeric_limits<int64_t>::min())
+    .imageWidth(1280).imageHeight(720).nBox(2).boxes(std::string(300, '\x80'));
+  failures += check("KiwiBoundingBoxArray min", boxes);
+  boxes.sampleTime(std::numeric_limits<int64_t>::max()).boxes(std::string());
+  failures += check("KiwiBoundingBoxArray max", boxes);
+
+  if (failures > 0) {
+    return 1;
+  }
+  std::cout << "All envelopes equal those of cluon." << std::endl;
+  return 0;
+}
@@ -0,0 +1,1468 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OD4_BUS_HPP
+#define OD4_BUS_HPP
+
+#include "cluon-complete.hpp"
+
+#include <arpa/inet.h>
+#include <endian.h>
+#include <fcntl.h>
+#include <ifaddrs.h>
+#include <linux/futex.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Intra-host transport for OD4 envelopes. Every producing process owns one
+// single-writer ring buffer in shared memory (/dev/shm/od4bus.<cid>.<token>)
+// and registers it in a per-CID directory (/dev/shm/od4bus.<cid>). Readers
+// keep their own cursor into each ring and sleep on a futex in the directory
+// that is bumped on every write. The rings carry the same serialized
+// envelopes as UDP, so all existing dataTrigger delegates work unchanged.
+namespace od4bus {
+
+constexpr uint32_t MAX_PRODUCERS{32};
+constexpr uint32_t MAX_IDS_PER_PRODUCER{16};
+constexpr uint64_t RING_CAPACITY{1 << 20};
+constexpr uint32_t WRAP_MARKER{0xFFFFFFFF};
+// Producers refresh their slot this often, whether they write or not.
+constexpr int64_t PRODUCER_HEARTBEAT_US{500000};
+// A producer that has not refreshed its slot for this long is no longer
+// trusted to deliver its message identifiers, and UDP copies are let
+// through again.
+constexpr int64_t PRODUCER_STALE_US{2000000};
+// A directory slot that has not been refreshed for this long is reclaimed.
+constexpr int64_t PRODUCER_RECLAIM_US{10000000};
+constexpr int64_t DIRECTORY_REFRESH_US{250000};
+constexpr long WAIT_TIMEOUT_NS{100000000};
+
+// port is the UDP source port that the producer sends its UDP copies from.
+struct Slot {
+  std::atomic<uint64_t> token;
+  std::atomic<int64_t> heartbeat;
+  std::atomic<uint32_t> port;
+};
+
+struct Directory {
+  std::atomic<uint32_t> doorbell;
+  std::atomic<uint32_t> waiters;
+  Slot slots[MAX_PRODUCERS];
+};
+
+struct RingHeader {
+  std::atomic<uint64_t> reserved;
+  std::atomic<uint64_t> head;
+  std::atomic<uint32_t> numberOfIds;
+  std::atomic<int32_t> ids[MAX_IDS_PER_PRODUCER];
+};
+
+// CLOCK_MONOTONIC is shared by all containers on the host, unlike PIDs.
+inline int64_t monotonicMicroseconds() noexcept {
+  struct timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+inline uint64_t align8(uint64_t v) noexcept {
+  return (v + 7) & ~static_cast<uint64_t>(7);
+}
+
+inline std::string directoryName(uint16_t cid) {
+  return "/od4bus." + std::to_string(cid);
+}
+
+inline std::string ringName(uint16_t cid, uint64_t token) {
+  std::stringstream sstr;
+  sstr << directoryName(cid) << "." << std::hex << token;
+  return sstr.str();
+}
+
+// Maps a named shared memory area, creating it zero-filled when missing. An
+// all-zero area is a valid empty directory or ring, so no initialisation
+// handshake between processes is needed.
+inline void *mapArea(std::string const &name, size_t size, bool create) noexcept {
+  int flags{O_RDWR};
+  if (create) {
+    flags |= O_CREAT;
+  }
+  int fd = shm_open(name.c_str(), flags, 0666);
+  if (fd < 0) {
+    return nullptr;
+  }
+  if (create) {
+    fchmod(fd, 0666);
+    struct stat st{};
+    if (0 != fstat(fd, &st) || (static_cast<size_t>(st.st_size) < size && 0 != ftruncate(fd, static_cast<off_t>(size)))) {
+      close(fd);
+      return nullptr;
+    }
+  }
+  void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  return (MAP_FAILED == ptr) ? nullptr : ptr;
+}
+
+inline void futexWake(std::atomic<uint32_t> *word) noexcept {
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+inline void futexWait(std::atomic<uint32_t> *word, uint32_t expected) noexcept {
+  struct timespec timeout{0, WAIT_TIMEOUT_NS};
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+// Proto encoding of messages and envelopes, byte for byte as by
+// cluon::ToProtoVisitor and cluon::serializeEnvelope, but appended to a
+// caller's buffer so that a buffer that is kept between sends stops
+// allocating once it has grown to the largest envelope.
+enum class FieldKind : uint8_t {
+  BOOL,
+  UINT8,
+  INT8,
+  UINT16,
+  INT16,
+  UINT32,
+  INT32,
+  UINT64,
+  INT64,
+  FLOAT,
+  DOUBLE
+};
+
+struct FieldLayout {
+  uint32_t key;
+  FieldKind kind;
+  size_t offset;
+};
+
+// Where the fields of a message type are and how they are encoded. A message
+// of scalar fields only (isFixed) can be encoded from the layout without
+// visiting it, which avoids the name strings built by accept().
+struct MessageLayout {
+  bool isFixed{true};
+  std::vector<FieldLayout> fields{};
+};
+
+constexpr uint8_t WIRE_VARINT{0};
+constexpr uint8_t WIRE_EIGHT_BYTES{1};
+constexpr uint8_t WIRE_LENGTH_DELIMITED{2};
+constexpr uint8_t WIRE_FOUR_BYTES{5};
+
+inline uint32_t fieldKey(uint32_t id, uint8_t wireType) noexcept {
+  return (id << 3) | wireType;
+}
+
+inline uint64_t zigZag(int64_t v) noexcept {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline size_t varIntSize(uint64_t v) noexcept {
+  size_t size{1};
+  while (0x7f < v) {
+    v >>= 7;
+    size++;
+  }
+  return size;
+}
+
+inline void appendVarInt(std::string &buffer, uint64_t v) noexcept {
+  while (0x7f < v) {
+    buffer.push_back(static_cast<char>((v & 0x7f) | 0x80));
+    v >>= 7;
+  }
+  buffer.push_back(static_cast<char>(v));
+}
+
+inline void appendField(std::string &buffer, uint32_t key, FieldKind kind, char const *field) noexcept {
+  appendVarInt(buffer, key);
+  switch (kind) {
+    case FieldKind::BOOL: {
+      bool v{false};
+      std::memcpy(&v, field, sizeof(v));
+      appendVarInt(buffer, v ? 1 : 0);
+      break;
+    }
+    case FieldKind::UINT8: {
+      uint8_t v{0};
+      std::memcpy(&v, field, sizeof(v));
+      appendVarInt(buffer, v);
+      break;
+    }
+    case FieldKind::INT8: {
+      int8_t v{0};
+      std::memcpy(&v, field, sizeof(v));
+      appendVarInt(buffer, zigZag(v));
+      break;
+    }
+    case FieldKind::UINT16: {
+      uint16_t v{0};
+      std::memcpy(&v, field, sizeof(v));
+      appendVarInt(buffer, v);
+      break;
+    }
+    case FieldKind::INT16: {
+      int16_t v{0};
+      std::memcpy(&v, field, sizeof(v));
+      appendVarInt(buffer, zigZag(v));
+      break;
+    }
+    case FieldKind::UINT32: {
+      uint32_t v{0};
+      std::memcpy(&v, field, sizeof(v));
+      appendVarInt(buffer, v);
+      break;
+    }
+    case FieldKind::INT32: {
+      int32_t v{0};
+      std::memcpy(&v, field, sizeof(v));
+      appendVarInt(buffer, zigZag(v));
+      break;
+    }
+    case FieldKind::UINT64: {
+      uint64_t v{0};
+      std::memcpy(&v, field, sizeof(v));
+      appendVarInt(buffer, v);
+      break;
+    }
+    case FieldKind::INT64: {
+      int64_t v{0};
+      std::memcpy(&v, field, sizeof(v));
+      appendVarInt(buffer, zigZag(v));
+      break;
+    }
+    case FieldKind::FLOAT: {
+      uint32_t v{0};
+      std::memcpy(&v, field, sizeof(v));
+      v = htole32(v);
+      buffer.append(reinterpret_cast<char const *>(&v), sizeof(v));
+      break;
+    }
+    case FieldKind::DOUBLE: {
+      uint64_t v{0};
+      std::memcpy(&v, field, sizeof(v));
+      v = htole64(v);
+      buffer.append(reinterpret_cast<char const *>(&v), sizeof(v));
+      break;
+    }
+  }
+}
+
+// A visitor that appends the proto encoding of a message to a buffer and,
+// given a layout, notes down where each field sits in the message.
+class ProtoWriter {
+ private:
+  ProtoWriter(ProtoWriter const &) = delete;
+  ProtoWriter(ProtoWriter &&) = delete;
+  ProtoWriter &operator=(ProtoWriter const &) = delete;
+  ProtoWriter &operator=(ProtoWriter &&) = delete;
+
+ public:
+  ProtoWriter(std::string &buffer, char const *message = nullptr, MessageLayout *layout = nullptr) noexcept
+    : m_buffer(buffer)
+    , m_message{message}
+    , m_layout{layout}
+  {
+  }
+
+  void preVisit(int32_t, std::string const &, std::string const &) noexcept {}
+  void postVisit() noexcept {}
+
+  void visit(uint32_t id, std::string &&, std::string &&, bool &v) noexcept {
+    scalar(fieldKey(id, WIRE_VARINT), FieldKind::BOOL, &v);
+  }
+  void visit(uint32_t id, std::string &&, std::string &&, char &v) noexcept {
+    scalar(fieldKey(id, WIRE_VARINT), FieldKind::UINT8, &v);
+  }
+  void visit(uint32_t id, std::string &&, std::string &&, int8_t &v) noexcept {
+    scalar(fieldKey(id, WIRE_VARINT), FieldKind::INT8, &v);
+  }
+  void visit(uint32_t id, std::string &&, std::string &&, uint8_t &v) noexcept {
+    scalar(fieldKey(id, WIRE_VARINT), FieldKind::UINT8, &v);
+  }
+  void visit(uint32_t id, std::string &&, std::string &&, int16_t &v) noexcept {
+    scalar(fieldKey(id, WIRE_VARINT), FieldKind::INT16, &v);
+  }
+  void visit(uint32_t id, std::string &&, std::string &&, uint16_t &v) noexcept {
+    scalar(fieldKey(id, WIRE_VARINT), FieldKind::UINT16, &v);
+  }
+  void visit(uint32_t id, std::string &&, std::string &&, int32_t &v) noexcept {
+    scalar(fieldKey(id, WIRE_VARINT), FieldKind::INT32, &v);
+  }
+  void visit(uint32_t id, std::string &&, std::string &&, uint32_t &v) noexcept {
+    scalar(fieldKey(id, WIRE_VARINT), FieldKind::UINT32, &v);
+  }
+  void visit(uint32_t id, std::string &&, std::string &&, int64_t &v) noexcept {
+    scalar(fieldKey(id, WIRE_VARINT), FieldKind::INT64, &v);
+  }
+  void visit(uint32_t id, std::string &&, std::string &&, uint64_t &v) noexcept {
+    scalar(fieldKey(id, WIRE_VARINT), FieldKind::UINT64, &v);
+  }
+  void visit(uint32_t id, std::string &&, std::string &&, float &v) noexcept {
+    scalar(fieldKey(id, WIRE_FOUR_BYTES), FieldKind::FLOAT, &v);
+  }
+  void visit(uint32_t id, std::string &&, std::string &&, double &v) noexcept {
+    scalar(fieldKey(id, WIRE_EIGHT_BYTES), FieldKind::DOUBLE, &v);
+  }
+  void visit(uint32_t id, std::string &&, std::string &&, std::string &v) noexcept {
+    appendVarInt(m_buffer, fieldKey(id, WIRE_LENGTH_DELIMITED));
+    appendVarInt(m_buffer, v.size());
+    m_buffer.append(v);
+    notFixed();
+  }
+
+  template <typename T>
+  void visit(uint32_t &id, std::string &&, std::string &&, T &value) noexcept {
+    std::string nested;
+    ProtoWriter nestedWriter{nested};
+    value.accept(nestedWriter);
+    appendVarInt(m_buffer, fieldKey(id, WIRE_LENGTH_DELIMITED));
+    appendVarInt(m_buffer, nested.size());
+    m_buffer.append(nested);
+    notFixed();
+  }
+
+ private:
+  void scalar(uint32_t key, FieldKind kind, void const *field) noexcept {
+    char const *bytes{static_cast<char const *>(field)};
+    appendField(m_buffer, key, kind, bytes);
+    if (nullptr != m_layout) {
+      m_layout->fields.push_back(FieldLayout{key, kind, static_cast<size_t>(bytes - m_message)});
+    }
+  }
+
+  void notFixed() noexcept {
+    if (nullptr != m_layout) {
+      m_layout->isFixed = false;
+    }
+  }
+
+ private:
+  std::string &m_buffer;
+  char const *m_message;
+  MessageLayout *m_layout;
+};
+
+template <typename T>
+MessageLayout layoutOf(T &message) noexcept {
+  MessageLayout layout;
+  std::string buffer;
+  ProtoWriter writer{buffer, reinterpret_cast<char const *>(&message), &layout};
+  message.accept(writer);
+  return layout;
+}
+
+// Appends the proto encoding of a message. The layout of a type is taken
+// from the first message of it that is sent.
+template <typename T>
+void appendMessage(std::string &buffer, T &message) noexcept {
+  static MessageLayout const layout{layoutOf(message)};
+  if (layout.isFixed) {
+    char const *fields{reinterpret_cast<char const *>(&message)};
+    for (auto const &field : layout.fields) {
+      appendField(buffer, field.key, field.kind, fields + field.offset);
+    }
+  } else {
+    ProtoWriter writer{buffer};
+    message.accept(writer);
+  }
+}
+
+inline void appendTimeStamp(std::string &buffer, uint32_t id, cluon::data::TimeStamp const &timeStamp) noexcept {
+  uint64_t const seconds{zigZag(timeStamp.seconds())};
+  uint64_t const microseconds{zigZag(timeStamp.microseconds())};
+  appendVarInt(buffer, fieldKey(id, WIRE_LENGTH_DELIMITED));
+  appendVarInt(buffer, 2 + varIntSize(seconds) + varIntSize(microseconds));
+  appendVarInt(buffer, fieldKey(1, WIRE_VARINT));
+  appendVarInt(buffer, seconds);
+  appendVarInt(buffer, fieldKey(2, WIRE_VARINT));
+  appendVarInt(buffer, microseconds);
+}
+
+// Replaces the content of buffer with the envelope, OD4 header included.
+inline void encodeEnvelope(std::string &buffer, int32_t dataType, std::string const &payload,
+    cluon::data::TimeStamp const &sent, cluon::data::TimeStamp const &sampleTimeStamp, uint32_t senderStamp) noexcept {
+  buffer.assign(5, '\0');
+  appendVarInt(buffer, fieldKey(1, WIRE_VARINT));
+  appendVarInt(buffer, zigZag(dataType));
+  appendVarInt(buffer, fieldKey(2, WIRE_LENGTH_DELIMITED));
+  appendVarInt(buffer, payload.size());
+  buffer.append(payload);
+  appendTimeStamp(buffer, 3, sent);
+  appendTimeStamp(buffer, 4, cluon::data::TimeStamp());
+  appendTimeStamp(buffer, 5, sampleTimeStamp);
+  appendVarInt(buffer, fieldKey(6, WIRE_VARINT));
+  appendVarInt(buffer, senderStamp);
+
+  uint32_t const length{htole32(static_cast<uint32_t>(buffer.size() - 5) << 8)};
+  std::memcpy(&buffer[1], &length, sizeof(uint32_t));
+  buffer[0] = static_cast<char>(0x0D);
+  buffer[1] = static_cast<char>(0xA4);
+}
+
+// Reads the size (OD4 header included) and the message identifier of the
+// envelope at data without decoding it. cluon encodes the dataType as the
+// first field of an envelope. False if data does not start with a complete
+// envelope.
+inline bool peekEnvelope(char const *data, size_t size, size_t &envelopeSize, int32_t &dataType) noexcept {
+  uint8_t const *bytes{reinterpret_cast<uint8_t const *>(data)};
+  if (size < 7 || 0x0D != bytes[0] || 0xA4 != bytes[1]) {
+    return false;
+  }
+  envelopeSize = 5 + (static_cast<size_t>(bytes[2]) | (static_cast<size_t>(bytes[3]) << 8) | (static_cast<size_t>(bytes[4]) << 16));
+  if (envelopeSize > size || fieldKey(1, WIRE_VARINT) != bytes[5]) {
+    return false;
+  }
+  uint64_t value{0};
+  for (size_t i{6}, shift{0}; i < envelopeSize && shift < 64; i++, shift += 7) {
+    value |= static_cast<uint64_t>(bytes[i] & 0x7f) << shift;
+    if (0 == (bytes[i] & 0x80)) {
+      dataType = static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+      return true;
+    }
+  }
+  return false;
+}
+
+inline std::pair<bool, cluon::data::Envelope> decodeEnvelope(char const *data, size_t envelopeSize) noexcept {
+  std::stringstream sstr(std::string(data, envelopeSize));
+  return cluon::extractEnvelope(sstr);
+}
+
+// How many envelopes a receiver handed to data triggers, and how many it
+// dropped unread as nothing was subscribed to their message identifier or
+// as a local producer delivered them through its ring already.
+struct DeliveryStats {
+  uint64_t delivered{0};
+  uint64_t filtered{0};
+};
+
+// The writing end, one per process and CID. A thread refreshes the slot's
+// heartbeat, so a producer that has nothing to send keeps its slot. One
+// that lost it anyway, for instance while its process was stopped, takes a
+// new slot and ring on its next write or heartbeat.
+class Producer {
+ private:
+  Producer(Producer const &) = delete;
+  Producer(Producer &&) = delete;
+  Producer &operator=(Producer const &) = delete;
+  Producer &operator=(Producer &&) = delete;
+
+ public:
+  Producer(uint16_t cid, Directory *directory, uint64_t token, uint16_t port) noexcept
+    : m_cid{cid}
+    , m_directory{directory}
+    , m_token{token}
+    , m_port{port}
+    , m_slot{nullptr}
+    , m_header{nullptr}
+    , m_data{nullptr}
+    , m_mutex{}
+    , m_isRunning{true}
+    , m_wakeUp{}
+    , m_heartbeat{}
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!claim()) {
+        if (nullptr == m_header) {
+          std::cerr << "[od4bus]: Could not create ring " << ringName(m_cid, m_token) << std::endl;
+        } else {
+          std::cerr << "[od4bus]: No free producer slot on CID " << m_cid << std::endl;
+        }
+      }
+    }
+    m_heartbeat = std::thread(&Producer::beat, this);
+  }
+
+  ~Producer() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_isRunning = false;
+    }
+    m_wakeUp.notify_all();
+    if (m_heartbeat.joinable()) {
+      m_heartbeat.join();
+    }
+    if (nullptr != m_slot) {
+      uint64_t expected{m_token};
+      m_slot->token.compare_exchange_strong(expected, 0);
+      m_directory->doorbell.fetch_add(1);
+      futexWake(&m_directory->doorbell);
+    }
+    if (nullptr != m_header) {
+      munmap(m_header, sizeof(RingHeader) + RING_CAPACITY);
+      shm_unlink(ringName(m_cid, m_token).c_str());
+    }
+  }
+
+  bool valid() noexcept {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return nullptr != m_slot;
+  }
+
+  // Appends one record holding one or more serialized envelopes.
+  void write(int32_t messageIdentifier, char const *data, uint32_t length) noexcept {
+    write(&messageIdentifier, 1, data, length);
+  }
+
+  // As above, for a record of envelopes of several message identifiers.
+  void write(int32_t const *messageIdentifiers, size_t numberOfIds, char const *data, uint32_t length) noexcept {
+    uint64_t const recordSize{align8(sizeof(uint32_t) + length)};
+    if (recordSize > RING_CAPACITY / 2) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!claim()) {
+      return;
+    }
+    for (size_t i{0}; i < numberOfIds; i++) {
+      announce(messageIdentifiers[i]);
+    }
+
+    uint64_t const head{m_header->head.load(std::memory_order_relaxed)};
+    uint64_t const offset{head % RING_CAPACITY};
+    uint64_t start{head};
+    if (offset + recordSize > RING_CAPACITY) {
+      start += RING_CAPACITY - offset;
+    }
+    uint64_t const end{start + recordSize};
+
+    // Seqlock: readers validate their copy against the reserved position.
+    m_header->reserved.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    if (start != head) {
+      std::memcpy(m_data + offset, &WRAP_MARKER, sizeof(uint32_t));
+    }
+    char *record{m_data + start % RING_CAPACITY};
+    std::memcpy(record, &length, sizeof(uint32_t));
+    std::memcpy(record + sizeof(uint32_t), data, length);
+    m_header->head.store(end, std::memory_order_release);
+
+    m_slot->heartbeat.store(monotonicMicroseconds(), std::memory_order_relaxed);
+    // Both sequentially consistent, as the consumer's waiters increment and
+    // doorbell re-check are: with a weaker ring, the load of waiters could
+    // pass the increment, miss a consumer about to sleep, and skip the wake.
+    m_directory->doorbell.fetch_add(1, std::memory_order_seq_cst);
+    if (0 < m_directory->waiters.load(std::memory_order_seq_cst)) {
+      futexWake(&m_directory->doorbell);
+    }
+  }
+
+ private:
+  // True if this producer holds a slot, taking one if it has none or lost
+  // its own: a free slot, or one whose producer has not been seen for
+  // PRODUCER_RECLAIM_US, whose ring is then removed. As the ring of a
+  // producer that lost its slot may have been removed that way, it starts
+  // over on a new one. Called under m_mutex.
+  bool claim() noexcept {
+    if (nullptr != m_slot) {
+      if (m_token == m_slot->token.load()) {
+        return true;
+      }
+      m_slot = nullptr;
+      munmap(m_header, sizeof(RingHeader) + RING_CAPACITY);
+      m_header = nullptr;
+      m_data = nullptr;
+    }
+    if (nullptr == m_header) {
+      void *area = mapArea(ringName(m_cid, m_token), sizeof(RingHeader) + RING_CAPACITY, true);
+      if (nullptr == area) {
+        return false;
+      }
+      m_header = static_cast<RingHeader *>(area);
+      m_data = static_cast<char *>(area) + sizeof(RingHeader);
+    }
+
+    int64_t const now{monotonicMicroseconds()};
+    for (uint32_t i{0}; i < MAX_PRODUCERS && nullptr == m_slot; i++) {
+      Slot &slot = m_directory->slots[i];
+      uint64_t current{slot.token.load()};
+      bool const isStale{now - slot.heartbeat.load() > PRODUCER_RECLAIM_US};
+      if ((0 == current || isStale) && slot.token.compare_exchange_strong(current, m_token)) {
+        if (0 != current) {
+          shm_unlink(ringName(m_cid, current).c_str());
+        }
+        slot.heartbeat.store(now);
+        slot.port.store(m_port);
+        m_slot = &slot;
+      }
+    }
+    if (nullptr == m_slot) {
+      return false;
+    }
+    m_directory->doorbell.fetch_add(1);
+    return true;
+  }
+
+  void beat() noexcept {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_isRunning) {
+      if (claim()) {
+        m_slot->heartbeat.store(monotonicMicroseconds(), std::memory_order_relaxed);
+      }
+      m_wakeUp.wait_for(lock, std::chrono::microseconds(PRODUCER_HEARTBEAT_US));
+    }
+  }
+
+  void announce(int32_t messageIdentifier) noexcept {
+    uint32_t const n{m_header->numberOfIds.load(std::memory_order_relaxed)};
+    for (uint32_t i{0}; i < n; i++) {
+      if (m_header->ids[i].load(std::memory_order_relaxed) == messageIdentifier) {
+        return;
+      }
+    }
+    if (n < MAX_IDS_PER_PRODUCER) {
+      m_header->ids[n].store(messageIdentifier, std::memory_order_relaxed);
+      m_header->numberOfIds.store(n + 1, std::memory_order_release);
+    }
+  }
+
+ private:
+  uint16_t const m_cid;
+  Directory *m_directory;
+  uint64_t const m_token;
+  uint16_t const m_port;
+  Slot *m_slot;
+  RingHeader *m_header;
+  char *m_data;
+  std::mutex m_mutex;
+  bool m_isRunning;
+  std::condition_variable m_wakeUp;
+  std::thread m_heartbeat;
+};
+
+// The reading end of one attached producer ring. The mapping is released
+// with the last copy of the reader.
+struct Reader {
+  uint64_t token{0};
+  Slot *slot{nullptr};
+  std::shared_ptr<RingHeader> header{};
+  char *data{nullptr};
+  uint64_t tail{0};
+};
+
+// Attaches to all producer rings of a CID and dispatches the envelopes on a
+// dedicated thread.
+class Consumer {
+ private:
+  Consumer(Consumer const &) = delete;
+  Consumer(Consumer &&) = delete;
+  Consumer &operator=(Consumer const &) = delete;
+  Consumer &operator=(Consumer &&) = delete;
+
+ public:
+  Consumer(uint16_t cid, Directory *directory, uint64_t ownToken) noexcept
+    : m_cid{cid}
+    , m_directory{directory}
+    , m_ownToken{ownToken}
+    , m_readers{}
+    , m_readersMutex{}
+    , m_announcers{std::make_shared<std::vector<Reader>>()}
+    , m_delegates{}
+    , m_delegatesMutex{}
+    , m_isStarted{false}
+    , m_delivered{0}
+    , m_filtered{0}
+    , m_running{true}
+    , m_thread{}
+  {
+    m_thread = std::thread(&Consumer::run, this);
+  }
+
+  ~Consumer() {
+    m_running.store(false);
+    futexWake(&m_directory->doorbell);
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+  }
+
+  void dataTrigger(int32_t messageIdentifier, std::function<void(cluon::data::Envelope &&envelope)> delegate) noexcept {
+    std::lock_guard<std::mutex> lock(m_delegatesMutex);
+    if (nullptr == delegate) {
+      m_delegates.erase(messageIdentifier);
+    } else {
+      m_delegates[messageIdentifier] = delegate;
+    }
+  }
+
+  DeliveryStats stats() const noexcept {
+    DeliveryStats stats;
+    stats.delivered = m_delivered.load(std::memory_order_relaxed);
+    stats.filtered = m_filtered.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+  // True if the live local producer that sends UDP from port announces this
+  // identifier, i.e., the UDP copy of an envelope from its ring should be
+  // dropped. Reads a copy of the attached rings, so the receiving thread
+  // does not wait for the delegates that run under m_readersMutex.
+  bool isProducedLocally(uint16_t port, int32_t messageIdentifier) noexcept {
+    int64_t const now{monotonicMicroseconds()};
+    std::shared_ptr<std::vector<Reader> const> const announcers{std::atomic_load(&m_announcers)};
+    for (auto const &reader : *announcers) {
+      if (reader.slot->port.load(std::memory_order_relaxed) != port
+          || reader.slot->token.load(std::memory_order_relaxed) != reader.token
+          || now - reader.slot->heartbeat.load(std::memory_order_relaxed) > PRODUCER_STALE_US) {
+        continue;
+      }
+      uint32_t const n{reader.header->numberOfIds.load(std::memory_order_acquire)};
+      for (uint32_t i{0}; i < n; i++) {
+        if (reader.header->ids[i].load(std::memory_order_relaxed) == messageIdentifier) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+ private:
+  void run() noexcept {
+    std::vector<char> record;
+    record.reserve(4096);
+    int64_t lastRefresh{0};
+    while (m_running.load()) {
+      uint32_t const seen{m_directory->doorbell.load(std::memory_order_acquire)};
+      int64_t const now{monotonicMicroseconds()};
+      if (now - lastRefresh > DIRECTORY_REFRESH_US) {
+        refresh();
+        lastRefresh = now;
+      }
+
+      bool received{false};
+      {
+        std::lock_guard<std::mutex> lock(m_readersMutex);
+        for (auto &reader : m_readers) {
+          received |= poll(reader, record);
+        }
+      }
+
+      if (!received) {
+        // Pairs with the doorbell ring and waiters load in Producer::write().
+        m_directory->waiters.fetch_add(1, std::memory_order_seq_cst);
+        if (seen == m_directory->doorbell.load(std::memory_order_seq_cst)) {
+          futexWait(&m_directory->doorbell, seen);
+        }
+        m_directory->waiters.fetch_sub(1);
+        // A changed doorbell may mean a new producer, so re-scan.
+        lastRefresh = 0;
+      }
+    }
+  }
+
+  void refresh() noexcept {
+    std::lock_guard<std::mutex> lock(m_readersMutex);
+    bool isChanged{false};
+    for (auto it = m_readers.begin(); it != m_readers.end();) {
+      if (it->slot->token.load() != it->token) {
+        it = m_readers.erase(it);
+        isChanged = true;
+      } else {
+        ++it;
+      }
+    }
+    for (uint32_t i{0}; i < MAX_PRODUCERS; i++) {
+      Slot &slot = m_directory->slots[i];
+      uint64_t const token{slot.token.load()};
+      if (0 == token || m_ownToken == token) {
+        continue;
+      }
+      bool isAttached{false};
+      for (auto const &reader : m_readers) {
+        isAttached |= (reader.token == token);
+      }
+      if (!isAttached) {
+        void *area = mapArea(ringName(m_cid, token), sizeof(RingHeader) + RING_CAPACITY, false);
+        if (nullptr != area) {
+          Reader reader;
+          reader.token = token;
+          reader.slot = &slot;
+          reader.header.reset(static_cast<RingHeader *>(area), [](RingHeader *header) {
+              munmap(header, sizeof(RingHeader) + RING_CAPACITY);
+            });
+          reader.data = static_cast<char *>(area) + sizeof(RingHeader);
+          // Rings that appear after start-up are read from their beginning
+          // so that the first envelopes of a new producer are not lost.
+          uint64_t const head{reader.header->head.load(std::memory_order_acquire)};
+          reader.tail = (m_isStarted && head <= RING_CAPACITY) ? 0 : head;
+          m_readers.push_back(reader);
+          isChanged = true;
+        }
+      }
+    }
+    if (isChanged) {
+      std::atomic_store(&m_announcers, std::shared_ptr<std::vector<Reader> const>{std::make_shared<std::vector<Reader>>(m_readers)});
+    }
+    m_isStarted = true;
+  }
+
+  bool poll(Reader &reader, std::vector<char> &record) noexcept {
+    bool received{false};
+    uint64_t const head{reader.header->head.load(std::memory_order_acquire)};
+    if (head - reader.tail > RING_CAPACITY) {
+      // Lapped by the writer; resume at the newest data as UDP would.
+      reader.tail = head;
+    }
+    while (reader.tail < head) {
+      uint64_t const offset{reader.tail % RING_CAPACITY};
+      uint32_t length{0};
+      std::memcpy(&length, reader.data + offset, sizeof(uint32_t));
+      if (WRAP_MARKER == length) {
+        reader.tail += RING_CAPACITY - offset;
+        continue;
+      }
+      if (offset + sizeof(uint32_t) + length > RING_CAPACITY) {
+        reader.tail = head;
+        break;
+      }
+      record.assign(reader.data + offset + sizeof(uint32_t), reader.data + offset + sizeof(uint32_t) + length);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (reader.header->reserved.load(std::memory_order_relaxed) - reader.tail > RING_CAPACITY) {
+        reader.tail = head;
+        break;
+      }
+      reader.tail += align8(sizeof(uint32_t) + length);
+      dispatch(record);
+      received = true;
+    }
+    return received;
+  }
+
+  // Envelopes of identifiers without a delegate are skipped undecoded.
+  void dispatch(std::vector<char> const &record) noexcept {
+    size_t offset{0};
+    size_t envelopeSize{0};
+    int32_t dataType{0};
+    while (peekEnvelope(record.data() + offset, record.size() - offset, envelopeSize, dataType)) {
+      std::function<void(cluon::data::Envelope &&envelope)> delegate{nullptr};
+      {
+        std::lock_guard<std::mutex> lock(m_delegatesMutex);
+        auto it = m_delegates.find(dataType);
+        if (it != m_delegates.end()) {
+          delegate = it->second;
+        }
+      }
+      if (nullptr == delegate) {
+        m_filtered.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        auto result = decodeEnvelope(record.data() + offset, envelopeSize);
+        if (result.first) {
+          result.second.received(cluon::time::now());
+          m_delivered.fetch_add(1, std::memory_order_relaxed);
+          delegate(std::move(result.second));
+        }
+      }
+      offset += envelopeSize;
+    }
+  }
+
+ private:
+  uint16_t const m_cid;
+  Directory *m_directory;
+  uint64_t const m_ownToken;
+  std::vector<Reader> m_readers;
+  std::mutex m_readersMutex;
+  std::shared_ptr<std::vector<Reader> const> m_announcers;
+  std::unordered_map<int32_t, std::function<void(cluon::data::Envelope &&envelope)>> m_delegates;
+  std::mutex m_delegatesMutex;
+  bool m_isStarted;
+  std::atomic<uint64_t> m_delivered;
+  std::atomic<uint64_t> m_filtered;
+  std::atomic<bool> m_running;
+  std::thread m_thread;
+};
+
+constexpr uint16_t OD4_PORT{12175};
+constexpr uint32_t RECEIVE_BATCH{32};
+constexpr size_t MAX_DATAGRAM{65507};
+constexpr int RECEIVE_TIMEOUT_MS{20};
+
+// What the batched UDP receiver has seen. drops is the number of datagrams
+// the kernel discarded as the socket buffer was full.
+struct ReceiveStats {
+  uint64_t datagrams{0};
+  uint64_t calls{0};
+  uint64_t drops{0};
+  double datagramsPerSecond{0.0};
+  DeliveryStats delivery{};
+};
+
+// An envelope of a received datagram that a delegate is waiting for.
+struct PendingEnvelope {
+  char const *data;
+  size_t size;
+  cluon::data::TimeStamp received;
+  std::shared_ptr<std::function<void(cluon::data::Envelope &&envelope)>> delegate;
+};
+
+// Receives the OD4 multicast group of a CID like cluon::UDPReceiver, but
+// reads up to RECEIVE_BATCH datagrams per recvmmsg() call into buffers that
+// are allocated once, and dispatches the envelopes of a call in one go on
+// the receiving thread. The message identifier is read from the raw bytes
+// first, so envelopes that nothing subscribed to are never decoded.
+// Datagrams sent from ownPort on this host are skipped, as OD4Session does
+// with its own sender, and so are those from another port on this host that
+// the duplicate filter, if set, tells apart as already delivered.
+class UdpReceiver {
+ private:
+  UdpReceiver(UdpReceiver const &) = delete;
+  UdpReceiver(UdpReceiver &&) = delete;
+  UdpReceiver &operator=(UdpReceiver const &) = delete;
+  UdpReceiver &operator=(UdpReceiver &&) = delete;
+
+  using Delegate = std::function<void(cluon::data::Envelope &&envelope)>;
+  using DuplicateFilter = std::function<bool(uint16_t port, int32_t messageIdentifier)>;
+
+ public:
+  UdpReceiver(uint16_t cid, uint16_t ownPort) noexcept
+    : m_socket{-1}
+    , m_ownPort{ownPort}
+    , m_localAddresses{}
+    , m_delegates{}
+    , m_isDuplicate{}
+    , m_delegatesMutex{}
+    , m_datagrams{0}
+    , m_calls{0}
+    , m_drops{0}
+    , m_datagramsPerSecond{0.0}
+    , m_delivered{0}
+    , m_filtered{0}
+    , m_running{false}
+    , m_thread{}
+  {
+    std::string const group{"225.0.0." + std::to_string(cid)};
+    m_socket = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (0 > m_socket) {
+      std::cerr << "[od4bus]: Could not open a UDP socket." << std::endl;
+      return;
+    }
+    int yes{1};
+    int receiveBuffer{26214400};
+    ::setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    ::setsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+    ::setsockopt(m_socket, SOL_SOCKET, SO_TIMESTAMP, &yes, sizeof(yes));
+#ifdef SO_RXQ_OVFL
+    ::setsockopt(m_socket, SOL_SOCKET, SO_RXQ_OVFL, &yes, sizeof(yes));
+#endif
+
+    struct sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = ::inet_addr(group.c_str());
+    address.sin_port = htons(OD4_PORT);
+    struct ip_mreq membership{};
+    membership.imr_multiaddr.s_addr = ::inet_addr(group.c_str());
+    membership.imr_interface.s_addr = htonl(INADDR_ANY);
+    if (0 != ::bind(m_socket, reinterpret_cast<struct sockaddr *>(&address), sizeof(address))
+        || 0 != ::setsockopt(m_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership))) {
+      std::cerr << "[od4bus]: Could not join " << group << ":" << OD4_PORT << "." << std::endl;
+      ::close(m_socket);
+      m_socket = -1;
+      return;
+    }
+
+    struct ifaddrs *interfaces{nullptr};
+    if (0 == ::getifaddrs(&interfaces)) {
+      for (struct ifaddrs *it = interfaces; nullptr != it; it = it->ifa_next) {
+        if (nullptr != it->ifa_addr && AF_INET == it->ifa_addr->sa_family) {
+          m_localAddresses.push_back(reinterpret_cast<struct sockaddr_in *>(it->ifa_addr)->sin_addr.s_addr);
+        }
+      }
+      ::freeifaddrs(interfaces);
+    }
+
+    m_running.store(true);
+    m_thread = std::thread(&UdpReceiver::run, this);
+  }
+
+  ~UdpReceiver() {
+    m_running.store(false);
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+    if (0 <= m_socket) {
+      ::close(m_socket);
+    }
+  }
+
+  bool isRunning() const noexcept {
+    return m_running.load();
+  }
+
+  void dataTrigger(int32_t messageIdentifier, Delegate delegate) noexcept {
+    std::lock_guard<std::mutex> lock(m_delegatesMutex);
+    if (nullptr == delegate) {
+      m_delegates.erase(messageIdentifier);
+    } else {
+      m_delegates[messageIdentifier] = std::make_shared<Delegate>(delegate);
+    }
+  }
+
+  // Called on the receiving thread with the source port and the message
+  // identifier of each envelope that was sent from this host.
+  void duplicateFilter(DuplicateFilter isDuplicate) noexcept {
+    std::lock_guard<std::mutex> lock(m_delegatesMutex);
+    m_isDuplicate = isDuplicate;
+  }
+
+  ReceiveStats stats() const noexcept {
+    ReceiveStats stats;
+    stats.datagrams = m_datagrams.load(std::memory_order_relaxed);
+    stats.calls = m_calls.load(std::memory_order_relaxed);
+    stats.drops = m_drops.load(std::memory_order_relaxed);
+    stats.datagramsPerSecond = m_datagramsPerSecond.load(std::memory_order_relaxed);
+    stats.delivery.delivered = m_delivered.load(std::memory_order_relaxed);
+    stats.delivery.filtered = m_filtered.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+ private:
+  void run() noexcept {
+    std::vector<char> buffers(RECEIVE_BATCH * MAX_DATAGRAM);
+    size_t const CONTROL_SIZE{CMSG_SPACE(sizeof(struct timeval)) + CMSG_SPACE(sizeof(uint32_t))};
+    std::vector<char> controls(RECEIVE_BATCH * CONTROL_SIZE);
+    std::vector<struct mmsghdr> messages(RECEIVE_BATCH);
+    std::vector<struct iovec> vectors(RECEIVE_BATCH);
+    std::vector<struct sockaddr_in> senders(RECEIVE_BATCH);
+    std::vector<PendingEnvelope> pending;
+    pending.reserve(RECEIVE_BATCH);
+
+    int64_t rateStart{monotonicMicroseconds()};
+    uint64_t rateDatagrams{0};
+    while (m_running.load()) {
+      struct pollfd readable{m_socket, POLLIN, 0};
+      if (0 < ::poll(&readable, 1, RECEIVE_TIMEOUT_MS)) {
+        int received{0};
+        do {
+          for (uint32_t i{0}; i < RECEIVE_BATCH; i++) {
+            vectors[i].iov_base = &buffers[i * MAX_DATAGRAM];
+            vectors[i].iov_len = MAX_DATAGRAM;
+            messages[i].msg_hdr.msg_name = &senders[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_control = &controls[i * CONTROL_SIZE];
+            messages[i].msg_hdr.msg_controllen = CONTROL_SIZE;
+            messages[i].msg_hdr.msg_flags = 0;
+          }
+          received = ::recvmmsg(m_socket, messages.data(), RECEIVE_BATCH, MSG_DONTWAIT, nullptr);
+          if (0 < received) {
+            m_calls.fetch_add(1, std::memory_order_relaxed);
+            m_datagrams.fetch_add(static_cast<uint64_t>(received), std::memory_order_relaxed);
+            rateDatagrams += static_cast<uint64_t>(received);
+            select(messages, senders, static_cast<uint32_t>(received), pending);
+            dispatch(pending);
+          }
+        } while (static_cast<int>(RECEIVE_BATCH) == received && m_running.load());
+      }
+
+      int64_t const now{monotonicMicroseconds()};
+      if (now - rateStart >= 1000000) {
+        m_datagramsPerSecond.store(1e6 * static_cast<double>(rateDatagrams) / static_cast<double>(now - rateStart),
+            std::memory_order_relaxed);
+        rateStart = now;
+        rateDatagrams = 0;
+      }
+    }
+  }
+
+  bool isLocal(struct sockaddr_in const &sender) const noexcept {
+    for (auto const address : m_localAddresses) {
+      if (address == sender.sin_addr.s_addr) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Collects the envelopes of the received datagrams that have a delegate,
+  // looking the delegates up under one lock.
+  void select(std::vector<struct mmsghdr> &messages, std::vector<struct sockaddr_in> const &senders, uint32_t count,
+      std::vector<PendingEnvelope> &pending) noexcept {
+    pending.clear();
+    uint64_t filtered{0};
+    std::lock_guard<std::mutex> lock(m_delegatesMutex);
+    for (uint32_t i{0}; i < count; i++) {
+      struct msghdr &header = messages[i].msg_hdr;
+      cluon::data::TimeStamp received{cluon::time::now()};
+      for (struct cmsghdr *control = CMSG_FIRSTHDR(&header); nullptr != control; control = CMSG_NXTHDR(&header, control)) {
+        if (SOL_SOCKET == control->cmsg_level && SO_TIMESTAMP == control->cmsg_type) {
+          struct timeval tv{};
+          std::memcpy(&tv, CMSG_DATA(control), sizeof(tv));
+          received.seconds(static_cast<int32_t>(tv.tv_sec)).microseconds(static_cast<int32_t>(tv.tv_usec));
+        }
+#ifdef SO_RXQ_OVFL
+        if (SOL_SOCKET == control->cmsg_level && SO_RXQ_OVFL == control->cmsg_type) {
+          uint32_t drops{0};
+          std::memcpy(&drops, CMSG_DATA(control), sizeof(drops));
+          m_drops.store(drops, std::memory_order_relaxed);
+        }
+#endif
+      }
+      bool const isFromHost{isLocal(senders[i])};
+      uint16_t const port{ntohs(senders[i].sin_port)};
+      if (isFromHost && port == m_ownPort) {
+        continue;
+      }
+
+      char const *data{static_cast<char const *>(header.msg_iov->iov_base)};
+      size_t const size{messages[i].msg_len};
+      size_t offset{0};
+      size_t envelopeSize{0};
+      int32_t dataType{0};
+      while (peekEnvelope(data + offset, size - offset, envelopeSize, dataType)) {
+        auto it = m_delegates.find(dataType);
+        if (it == m_delegates.end() || (isFromHost && m_isDuplicate && m_isDuplicate(port, dataType))) {
+          filtered++;
+        } else {
+          pending.push_back(PendingEnvelope{data + offset, envelopeSize, received, it->second});
+        }
+        offset += envelopeSize;
+      }
+    }
+    m_filtered.fetch_add(filtered, std::memory_order_relaxed);
+  }
+
+  void dispatch(std::vector<PendingEnvelope> &pending) noexcept {
+    for (auto &entry : pending) {
+      auto result = decodeEnvelope(entry.data, entry.size);
+      if (result.first) {
+        result.second.received(entry.received);
+        m_delivered.fetch_add(1, std::memory_order_relaxed);
+        (*entry.delegate)(std::move(result.second));
+      }
+    }
+    pending.clear();
+  }
+
+ private:
+  int m_socket;
+  uint16_t const m_ownPort;
+  std::vector<in_addr_t> m_localAddresses;
+  std::unordered_map<int32_t, std::shared_ptr<Delegate>> m_delegates;
+  DuplicateFilter m_isDuplicate;
+  std::mutex m_delegatesMutex;
+  std::atomic<uint64_t> m_datagrams;
+  std::atomic<uint64_t> m_calls;
+  std::atomic<uint64_t> m_drops;
+  std::atomic<double> m_datagramsPerSecond;
+  std::atomic<uint64_t> m_delivered;
+  std::atomic<uint64_t> m_filtered;
+  std::atomic<bool> m_running;
+  std::thread m_thread;
+};
+
+}
+
+// Drop-in replacement for cluon::OD4Session. Without the shared-memory bus
+// it forwards everything to the wrapped OD4Session. With it, envelopes are
+// additionally written to the local ring, and data triggers are served from
+// the rings of all local producers. Each producer announces the UDP port it
+// sends from, and the UDP copies from that port of identifiers in its ring
+// are dropped, so every envelope is delivered once; the same identifiers
+// from other hosts or processes still arrive over UDP. UDP stays available
+// for external tools in both modes.
+//
+// With batchedReceive, UDP is read by an od4bus::UdpReceiver instead of the
+// OD4Session, several datagrams per system call; sending then does without
+// an OD4Session too. The shared-memory bus always receives this way, as
+// OD4Session does not tell the sender of a datagram.
+class Od4Bus {
+ private:
+  Od4Bus(Od4Bus const &) = delete;
+  Od4Bus(Od4Bus &&) = delete;
+  Od4Bus &operator=(Od4Bus const &) = delete;
+  Od4Bus &operator=(Od4Bus &&) = delete;
+
+ public:
+  Od4Bus(uint16_t cid, bool useSharedMemory, bool batchedReceive = false) noexcept
+    : m_cid{cid}
+    , m_od4{}
+    , m_sender{"225.0.0." + std::to_string(cid), od4bus::OD4_PORT}
+    , m_receiver{}
+    , m_directory{nullptr}
+    , m_token{0}
+    , m_producer{}
+    , m_consumer{}
+    , m_mutex{}
+    , m_overruns{0}
+  {
+    if (batchedReceive || useSharedMemory) {
+      m_receiver.reset(new od4bus::UdpReceiver{cid, m_sender.getSendFromPort()});
+    } else {
+      m_od4.reset(new cluon::OD4Session{cid});
+    }
+    if (useSharedMemory) {
+      m_directory = static_cast<od4bus::Directory *>(
+          od4bus::mapArea(od4bus::directoryName(cid), sizeof(od4bus::Directory), true));
+      if (nullptr == m_directory) {
+        std::cerr << "[od4bus]: Could not map " << od4bus::directoryName(cid) << ", using UDP only." << std::endl;
+      }
+      std::random_device rd;
+      while (0 == m_token) {
+        m_token = (static_cast<uint64_t>(rd()) << 32) | rd();
+      }
+    }
+  }
+
+  ~Od4Bus() {
+    m_receiver.reset();
+    m_od4.reset();
+    m_consumer.reset();
+    m_producer.reset();
+    if (nullptr != m_directory) {
+      munmap(m_directory, sizeof(od4bus::Directory));
+    }
+  }
+
+  bool usesSharedMemory() const noexcept {
+    return nullptr != m_directory;
+  }
+
+  // Counters of the batched receiver; all zero without batchedReceive or the
+  // shared-memory bus.
+  od4bus::ReceiveStats receiveStats() const noexcept {
+    return m_receiver ? m_receiver->stats() : od4bus::ReceiveStats{};
+  }
+
+  // Envelopes taken from the rings of local producers; zero without the
+  // shared-memory bus or before the first data trigger.
+  od4bus::DeliveryStats sharedMemoryStats() noexcept {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_consumer ? m_consumer->stats() : od4bus::DeliveryStats{};
+  }
+
+  template <typename T>
+  void send(T &message, cluon::data::TimeStamp const &sampleTimeStamp = cluon::data::TimeStamp(), uint32_t senderStamp = 0) noexcept {
+    if (!usesSharedMemory() && m_od4) {
+      m_od4->send(message, sampleTimeStamp, senderStamp);
+      return;
+    }
+    cluon::ToProtoVisitor protoEncoder;
+    cluon::data::Envelope envelope;
+    envelope.dataType(static_cast<int32_t>(message.ID()));
+    message.accept(protoEncoder);
+    envelope.serializedData(protoEncoder.encodedData());
+    envelope.sent(cluon::time::now());
+    envelope.sampleTimeStamp((0 == (sampleTimeStamp.seconds() + sampleTimeStamp.microseconds())) ? envelope.sent() : sampleTimeStamp);
+    envelope.senderStamp(senderStamp);
+
+    std::string data{cluon::serializeEnvelope(cluon::data::Envelope{envelope})};
+    if (usesSharedMemory()) {
+      producer().write(envelope.dataType(), data.data(), static_cast<uint32_t>(data.size()));
+    }
+    if (m_od4) {
+      m_od4->send(std::move(envelope));
+    } else {
+      m_sender.send(std::move(data));
+    }
+  }
+
+  // Sends envelopes that are already serialized (see Od4Batch). On the
+  // shared-memory bus they go as one record, assembled in the caller's
+  // record buffer. UDP gets one datagram per envelope, as an OD4Session
+  // only takes the first envelope of a datagram.
+  void send(int32_t const *messageIdentifiers, std::string *envelopes, size_t count, std::string &record) noexcept {
+    if (usesSharedMemory() && 0 < count) {
+      if (1 == count) {
+        producer().write(messageIdentifiers[0], envelopes[0].data(), static_cast<uint32_t>(envelopes[0].size()));
+      } else {
+        record.clear();
+        for (size_t i{0}; i < count; i++) {
+          record.append(envelopes[i]);
+        }
+        producer().write(messageIdentifiers, count, record.data(), static_cast<uint32_t>(record.size()));
+      }
+    }
+    for (size_t i{0}; i < count; i++) {
+      // Only read from; the string is not moved from.
+      m_sender.send(std::move(envelopes[i]));
+    }
+  }
+
+  bool dataTrigger(int32_t messageIdentifier, std::function<void(cluon::data::Envelope &&envelope)> delegate) noexcept {
+    if (!usesSharedMemory() || nullptr == delegate) {
+      if (usesSharedMemory()) {
+        consumer().dataTrigger(messageIdentifier, nullptr);
+      }
+      return udpTrigger(messageIdentifier, delegate);
+    }
+    od4bus::Consumer &local = consumer();
+    local.dataTrigger(messageIdentifier, delegate);
+    m_receiver->duplicateFilter([&local](uint16_t port, int32_t dataType) {
+        return local.isProducedLocally(port, dataType);
+      });
+    return udpTrigger(messageIdentifier, delegate);
+  }
+
+  // Calls the delegate at freq until it returns false, like
+  // OD4Session::timeTrigger(), but against absolute deadlines: that one
+  // sleeps whole milliseconds after each call, so every period is off by
+  // the call's run time and rounding. A call that overruns its period is
+  // counted in overruns(), and the next one starts right away; nothing is
+  // written from the loop, which may run in real time.
+  void timeTrigger(float freq, std::function<bool()> delegate) noexcept {
+    auto const period{std::chrono::microseconds(static_cast<int64_t>(1000000 / ((freq > 0) ? freq : 1.0f)))};
+    auto deadline{std::chrono::steady_clock::now()};
+    bool isDelegateRunning{nullptr != delegate};
+    while (isDelegateRunning && !cluon::TerminateHandler::instance().isTerminated.load()) {
+      try {
+        isDelegateRunning = delegate();
+      } catch (...) {
+        isDelegateRunning = false;
+      }
+      deadline += period;
+      auto const now{std::chrono::steady_clock::now()};
+      if (now < deadline) {
+        std::this_thread::sleep_until(deadline);
+      } else {
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+        deadline = now;
+      }
+    }
+  }
+
+  bool isRunning() noexcept {
+    return m_od4 ? m_od4->isRunning() : m_receiver->isRunning();
+  }
+
+  // Calls of timeTrigger()'s delegate that overran their period.
+  uint64_t overruns() const noexcept {
+    return m_overruns.load(std::memory_order_relaxed);
+  }
+
+ private:
+  bool udpTrigger(int32_t messageIdentifier, std::function<void(cluon::data::Envelope &&envelope)> delegate) noexcept {
+    if (m_od4) {
+      return m_od4->dataTrigger(messageIdentifier, delegate);
+    }
+    m_receiver->dataTrigger(messageIdentifier, delegate);
+    return true;
+  }
+
+  od4bus::Producer &producer() noexcept {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_producer) {
+      m_producer.reset(new od4bus::Producer(m_cid, m_directory, m_token, m_sender.getSendFromPort()));
+    }
+    return *m_producer;
+  }
+
+  od4bus::Consumer &consumer() noexcept {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_consumer) {
+      m_consumer.reset(new od4bus::Consumer(m_cid, m_directory, m_token));
+    }
+    return *m_consumer;
+  }
+
+ private:
+  uint16_t const m_cid;
+  std::unique_ptr<cluon::OD4Session> m_od4;
+  cluon::UDPSender m_sender;
+  std::unique_ptr<od4bus::UdpReceiver> m_receiver;
+  od4bus::Directory *m_directory;
+  uint64_t m_token;
+  std::unique_ptr<od4bus::Producer> m_producer;
+  std::unique_ptr<od4bus::Consumer> m_consumer;
+  std::mutex m_mutex;
+  std::atomic<uint64_t> m_overruns;
+};
+
+// Collects the messages of one control tick or camera frame and sends them
+// together. Envelopes are encoded into buffers that the batch keeps, so once
+// they have grown to size, a send does not allocate: messages of scalar
+// fields only (such as GroundSteeringRequest, PedalPositionRequest and
+// NearFarPoints) are encoded from their precomputed layout, the envelope
+// around them is written directly, and only the values and time stamps
+// differ from one send to the next. Not thread-safe; use one batch per
+// sending thread.
+class Od4Batch {
+ private:
+  Od4Batch(Od4Batch const &) = delete;
+  Od4Batch(Od4Batch &&) = delete;
+  Od4Batch &operator=(Od4Batch const &) = delete;
+  Od4Batch &operator=(Od4Batch &&) = delete;
+
+ public:
+  explicit Od4Batch(Od4Bus &od4) noexcept
+    : m_od4(od4)
+    , m_ids{}
+    , m_envelopes{}
+    , m_count{0}
+    , m_payload{}
+    , m_record{}
+  {
+  }
+
+  // Same arguments as Od4Bus::send(); the sent time is taken now.
+  template <typename T>
+  void add(T &message, cluon::data::TimeStamp const &sampleTimeStamp = cluon::data::TimeStamp(), uint32_t senderStamp = 0) noexcept {
+    if (m_count == m_envelopes.size()) {
+      m_envelopes.emplace_back();
+      m_ids.push_back(0);
+    }
+    m_payload.clear();
+    od4bus::appendMessage(m_payload, message);
+    cluon::data::TimeStamp const sent{cluon::time::now()};
+    bool const hasSampleTime{0 != (sampleTimeStamp.seconds() + sampleTimeStamp.microseconds())};
+    od4bus::encodeEnvelope(m_envelopes[m_count], static_cast<int32_t>(message.ID()), m_payload, sent,
+        hasSampleTime ? sampleTimeStamp : sent, senderStamp);
+    m_ids[m_count] = static_cast<int32_t>(message.ID());
+    m_count++;
+  }
+
+  void send() noexcept {
+    m_od4.send(m_ids.data(), m_envelopes.data(), m_count, m_record);
+    m_count = 0;
+  }
+
+ private:
+  Od4Bus &m_od4;
+  std::vector<int32_t> m_ids;
+  std::vector<std::string> m_envelopes;
+  size_t m_count;
+  std::string m_payload;
+  std::string m_record;
+};
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PERCEPTION_ARRAYS_HPP
+#define PERCEPTION_ARRAYS_HPP
+
+#include "opendlv-standard-message-set.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// KiwiBoundingBoxArray and ConeArray carry all detections of a camera frame
+// in one envelope. The detections are packed into a bytes field as
+// little-endian int16 values, clamped to that range: x, y, width and height
+// per box, and x, y and colour per cone, all in frame pixels. A frame then
+// costs a single length-delimited field instead of one message per box, and
+// packing is one pass over the detector's own array.
+
+enum class ConeColour : uint8_t {
+  Blue = 0,
+  Yellow = 1,
+  Red = 2
+};
+
+struct PackedBox {
+  int32_t x;
+  int32_t y;
+  int32_t width;
+  int32_t height;
+};
+
+struct PackedCone {
+  int32_t x;
+  int32_t y;
+  ConeColour colour;
+};
+
+inline void appendInt16(std::string &out, int32_t value) {
+  uint16_t const bits{static_cast<uint16_t>(std::min(std::max(value, -32768), 32767))};
+  out.push_back(static_cast<char>(bits & 0xff));
+  out.push_back(static_cast<char>(bits >> 8));
+}
+
+inline int32_t readInt16(std::string const &data, size_t offset) {
+  uint16_t const bits{static_cast<uint16_t>(static_cast<uint8_t>(data[offset])
+      | (static_cast<uint8_t>(data[offset + 1]) << 8))};
+  return static_cast<int16_t>(bits);
+}
+
+// Packs boxes with x, y, width and height members (such as cv::Rect) into
+// out, keeping its capacity.
+template <typename Box>
+void packBoxes(std::vector<Box> const &boxes, std::string &out) {
+  out.clear();
+  out.reserve(boxes.size() * 8);
+  for (auto const &box : boxes) {
+    appendInt16(out, box.x);
+    appendInt16(out, box.y);
+    appendInt16(out, box.width);
+    appendInt16(out, box.height);
+  }
+}
+
+inline std::vector<PackedBox> unpackBoxes(std::string const &data) {
+  std::vector<PackedBox> boxes;
+  for (size_t offset = 0; offset + 8 <= data.size(); offset += 8) {
+    boxes.push_back(PackedBox{readInt16(data, offset), readInt16(data, offset + 2),
+        readInt16(data, offset + 4), readInt16(data, offset + 6)});
+  }
+  return boxes;
+}
+
+inline void packCones(std::vector<PackedCone> const &cones, std::string &out) {
+  out.clear();
+  out.reserve(cones.size() * 6);
+  for (auto const &cone : cones) {
+    appendInt16(out, cone.x);
+    appendInt16(out, cone.y);
+    appendInt16(out, static_cast<int32_t>(cone.colour));
+  }
+}
+
+inline std::vector<PackedCone> unpackCones(std::string const &data) {
+  std::vector<PackedCone> cones;
+  for (size_t offset = 0; offset + 6 <= data.size(); offset += 6) {
+    cones.push_back(PackedCone{readInt16(data, offset), readInt16(data, offset + 2),
+        static_cast<ConeColour>(readInt16(data, offset + 4))});
+  }
+  return cones;
+}
+
+// The largest box of a frame, which is the nearest Kiwi, in the form the
+// control logic takes. nBox is the number of boxes in the frame; without
+// boxes, the box is empty.
+inline opendlv::perception::KiwiBoundingBox nearestKiwiBoundingBox(
+    opendlv::perception::KiwiBoundingBoxArray const &kiwis) {
+  opendlv::perception::KiwiBoundingBox kiwi;
+  kiwi.imageWidth(kiwis.imageWidth());
+  kiwi.imageHeight(kiwis.imageHeight());
+  kiwi.predicted(kiwis.predicted());
+  kiwi.age(kiwis.age());
+  std::vector<PackedBox> const boxes{unpackBoxes(kiwis.boxes())};
+  kiwi.nBox(static_cast<uint32_t>(boxes.size()));
+  int64_t largestArea{-1};
+  for (auto const &box : boxes) {
+    int64_t const area{static_cast<int64_t>(box.width) * box.height};
+    if (area > largestArea) {
+      largestArea = area;
+      kiwi.x(static_cast<uint32_t>(std::max(box.x, 0)));
+      kiwi.y(static_cast<uint32_t>(std::max(box.y, 0)));
+      kiwi.w(static_cast<uint32_t>(std::max(box.width, 0)));
+      kiwi.h(static_cast<uint32_t>(std::max(box.height, 0)));
+    }
+  }
+  return kiwi;
+}
+
+inline opendlv::perception::cognition::NearFarPoints nearFarPointsOf(
+    opendlv::perception::ConeArray const &cones) {
+  opendlv::perception::cognition::NearFarPoints nfPoints;
+  nfPoints.nearX(cones.nearX());
+  nfPoints.nearY(cones.nearY());
+  nfPoints.farX(cones.farX());
+  nfPoints.farY(cones.farY());
+  nfPoints.reachCrossRoad(cones.reachCrossRoad());
+  return nfPoints;
+}
+
+#endif
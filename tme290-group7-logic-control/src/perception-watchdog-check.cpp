@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cluon-complete.hpp"
+#include "opendlv-standard-message-set.hpp"
+#include "perception-watchdog.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+static uint32_t failures{0};
+
+static void expect(bool isTrue, std::string const &what) {
+  if (!isTrue) {
+    std::cerr << "Failed: " << what << std::endl;
+    failures++;
+  }
+}
+
+static DegradationPolicy::Requests requests(float groundSteering, float position) {
+  DegradationPolicy::Requests request;
+  request.first.groundSteering(groundSteering);
+  request.second.position(position);
+  return request;
+}
+
+static bool isEqual(DegradationPolicy::Requests const &a, DegradationPolicy::Requests const &b) {
+  return std::fabs(a.first.groundSteering() - b.first.groundSteering()) < 1e-6f
+    && std::fabs(a.second.position() - b.second.position()) < 1e-6f;
+}
+
+static void checkDeadlinesFrom() {
+  struct Case {
+    std::string value;
+    bool isValid;
+    Deadlines deadlines;
+  };
+  std::vector<Case> const CASES{
+    {"300,600,1000", true, {300.0, 600.0, 1000.0}},
+    {"0,0,1000", true, {0.0, 0.0, 1000.0}},
+    {"300,,1000", true, {300.0, 0.0, 1000.0}},
+    {"250.5", true, {250.5, 0.0, 0.0}},
+    {"", true, {0.0, 0.0, 0.0}},
+    {"600,300,1000", false, {}},
+    {"300,300", false, {}},
+    {"1000,0,500", false, {}},
+    {"-1,600,1000", false, {}},
+    {"300,600,1000,2000", false, {}},
+    {"300ms", false, {}},
+    {"a", false, {}},
+    {"inf", false, {}},
+    {"nan", false, {}}};
+  for (auto const &c : CASES) {
+    Deadlines deadlines{1.0, 2.0, 3.0};
+    bool const isValid{deadlinesFrom(c.value, deadlines)};
+    Deadlines const expected{c.isValid ? c.deadlines : Deadlines{1.0, 2.0, 3.0}};
+    expect(isValid == c.isValid, "deadlinesFrom(\"" + c.value + "\") gives " + (c.isValid ? "true" : "false"));
+    expect(std::fabs(deadlines.reduce - expected.reduce) < 1e-9 && std::fabs(deadlines.hold - expected.hold) < 1e-9
+        && std::fabs(deadlines.stop - expected.stop) < 1e-9,
+        "deadlinesFrom(\"" + c.value + "\") " + (c.isValid ? "sets the deadlines" : "leaves the deadlines as they are"));
+  }
+}
+
+static void checkPedalFrom() {
+  struct Case {
+    std::string value;
+    bool isValid;
+    float pedal;
+  };
+  std::vector<Case> const CASES{
+    {"0.05", true, 0.05f},
+    {"0", true, 0.0f},
+    {"1", true, 1.0f},
+    {"", false, 0.0f},
+    {"-0.1", false, 0.0f},
+    {"1.5", false, 0.0f},
+    {"0.1x", false, 0.0f},
+    {"a", false, 0.0f},
+    {"inf", false, 0.0f},
+    {"nan", false, 0.0f}};
+  for (auto const &c : CASES) {
+    float pedal{0.5f};
+    bool const isValid{pedalFrom(c.value, pedal)};
+    float const expected{c.isValid ? c.pedal : 0.5f};
+    expect(isValid == c.isValid, "pedalFrom(\"" + c.value + "\") gives " + (c.isValid ? "true" : "false"));
+    expect(std::fabs(pedal - expected) < 1e-6f,
+        "pedalFrom(\"" + c.value + "\") " + (c.isValid ? "sets the pedal" : "leaves the pedal as it is"));
+  }
+}
+
+static void checkDegradation() {
+  double const INFINITE{std::numeric_limits<double>::infinity()};
+  Deadlines const ALL{300.0, 600.0, 1000.0};
+  expect(ALL.enabled(), "deadlines with stages are enabled");
+  expect(!Deadlines{}.enabled(), "deadlines without stages are not enabled");
+  expect(ALL.degradation(0.0) == Degradation::None, "a fresh input does not degrade");
+  expect(ALL.degradation(300.0) == Degradation::None, "an input at the deadline does not degrade yet");
+  expect(ALL.degradation(300.1) == Degradation::Reduced, "an input past the first deadline reduces");
+  expect(ALL.degradation(600.1) == Degradation::Hold, "an input past the second deadline holds");
+  expect(ALL.degradation(1000.1) == Degradation::Stop, "an input past the third deadline stops");
+  expect(ALL.degradation(INFINITE) == Degradation::Stop, "an input never received stops");
+
+  Deadlines const STOP_ONLY{0.0, 0.0, 1000.0};
+  expect(STOP_ONLY.degradation(999.0) == Degradation::None, "a stage set to 0 is left out");
+  expect(STOP_ONLY.degradation(1000.1) == Degradation::Stop, "with the stop stage only, a late input stops");
+  Deadlines const HOLD_ONLY{0.0, 600.0, 0.0};
+  expect(HOLD_ONLY.degradation(INFINITE) == Degradation::Hold, "without a stop stage, an input never received holds");
+  expect(Deadlines{}.degradation(INFINITE) == Degradation::None, "without stages, nothing degrades");
+
+  expect(std::isinf(InputAge{}.age(cluon::time::toMicroseconds(cluon::time::now()))),
+      "an input is infinitely old before its first message");
+  InputAge age;
+  cluon::data::Envelope envelope;
+  int64_t const nowUs{cluon::time::toMicroseconds(cluon::time::now())};
+  envelope.sampleTimeStamp(cluon::time::fromMicroseconds(nowUs - 500000));
+  age.received(envelope);
+  expect(std::fabs(age.age(nowUs) - 500.0) < 1e-6, "the age is taken from the sample time");
+  expect(age.age(nowUs - 1000000) < 1e-9, "the age is never negative");
+  envelope.sampleTimeStamp(cluon::time::fromMicroseconds(nowUs + 60000000));
+  age.received(envelope);
+  expect(age.age(nowUs + 1000000) > 999.0, "a sample time ahead of the clock is replaced by the time of receipt");
+}
+
+static void checkPolicy() {
+  float const CAP{0.1f};
+  DegradationPolicy policy{CAP};
+  expect(DegradationPolicy::runsController(Degradation::None) && DegradationPolicy::runsController(Degradation::Reduced)
+      && !DegradationPolicy::runsController(Degradation::Hold) && !DegradationPolicy::runsController(Degradation::Stop),
+      "the controller runs with none and reduced only");
+
+  DegradationPolicy::Requests const FRESH{requests(0.3f, 0.5f)};
+  expect(isEqual(policy.apply(Degradation::None, FRESH), FRESH), "none passes the requests on");
+  expect(isEqual(policy.apply(Degradation::Reduced, requests(-0.2f, 0.5f)), requests(-0.2f, CAP)),
+      "reduced caps the pedal and keeps the steering");
+  expect(isEqual(policy.apply(Degradation::Reduced, requests(-0.2f, -0.5f)), requests(-0.2f, -0.5f)),
+      "reduced keeps a braking pedal");
+  expect(isEqual(policy.apply(Degradation::Hold, requests(0.0f, 0.0f)), requests(0.3f, CAP)),
+      "hold repeats the last fresh requests with the pedal capped");
+  expect(isEqual(policy.apply(Degradation::Stop, FRESH), requests(0.0f, 0.0f)), "stop gives zero pedal and straight wheels");
+  expect(isEqual(policy.apply(Degradation::Hold, requests(0.0f, 0.0f)), requests(0.3f, CAP)),
+      "hold after stop still repeats the last fresh requests");
+
+  DegradationPolicy::Requests const RECOVERED{requests(-0.1f, 0.05f)};
+  expect(isEqual(policy.apply(Degradation::None, RECOVERED), RECOVERED), "none after stop passes the requests on");
+  expect(isEqual(policy.apply(Degradation::Hold, FRESH), RECOVERED), "hold repeats the requests of the latest fresh tick");
+
+  DegradationPolicy unused{CAP};
+  expect(isEqual(unused.apply(Degradation::Hold, FRESH), requests(0.0f, 0.0f)),
+      "hold before any fresh tick gives zero pedal and straight wheels");
+}
+
+// Runs the parsing of the flags, the deadlines, the input ages and the
+// degradation policy of the control loop through their transitions. Exits
+// with 1 if any check fails.
+int32_t main() {
+  checkDeadlinesFrom();
+  checkPedalFrom();
+  checkDegradation();
+  checkPolicy();
+  if (failures > 0) {
+    std::cerr << failures << " check(s) failed." << std::endl;
+    return 1;
+  }
+  std::cout << "All deadline and degradation checks passed." << std::endl;
+  return 0;
+}
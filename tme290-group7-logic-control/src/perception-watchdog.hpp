@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PERCEPTION_WATCHDOG_HPP
+#define PERCEPTION_WATCHDOG_HPP
+
+#include "cluon-complete.hpp"
+#include "opendlv-standard-message-set.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <utility>
+
+// What the control loop does while an input is late, from mild to severe.
+//   Reduced: the controller still runs, with the pedal capped
+//   Hold:    the controller is not run; the requests of the last tick with
+//            fresh inputs are repeated, with the pedal capped
+//   Stop:    zero pedal and straight wheels until the input is fresh again
+enum class Degradation : int32_t {
+  None = 0,
+  Reduced = 1,
+  Hold = 2,
+  Stop = 3
+};
+
+inline char const *degradationName(Degradation degradation) noexcept {
+  switch (degradation) {
+    case Degradation::Reduced: return "reduced speed";
+    case Degradation::Hold: return "hold";
+    case Degradation::Stop: return "stop";
+    default: return "none";
+  }
+}
+
+// The ages (ms) from which an input degrades the control; 0 leaves a stage
+// out.
+struct Deadlines {
+  double reduce{0.0};
+  double hold{0.0};
+  double stop{0.0};
+
+  bool enabled() const noexcept {
+    return reduce > 0.0 || hold > 0.0 || stop > 0.0;
+  }
+
+  Degradation degradation(double age) const noexcept {
+    if (stop > 0.0 && age > stop) {
+      return Degradation::Stop;
+    }
+    if (hold > 0.0 && age > hold) {
+      return Degradation::Hold;
+    }
+    if (reduce > 0.0 && age > reduce) {
+      return Degradation::Reduced;
+    }
+    return Degradation::None;
+  }
+};
+
+// "<reduce>,<hold>,<stop>" in ms, e.g. "300,600,1000" or "0,0,1000". Gives
+// false, and leaves deadlines as they are, unless every stage is a number
+// of at least 0 and the stages that are set increase.
+inline bool deadlinesFrom(std::string const &value, Deadlines &deadlines) {
+  double stages[3]{0.0, 0.0, 0.0};
+  std::stringstream sstr(value);
+  std::string stage;
+  size_t count{0};
+  while (std::getline(sstr, stage, ',')) {
+    if (count == 3) {
+      return false;
+    }
+    if (!stage.empty()) {
+      size_t end{0};
+      try {
+        stages[count] = std::stod(stage, &end);
+      } catch (std::exception const &) {
+        return false;
+      }
+      if (end != stage.size() || !(stages[count] >= 0.0) || std::isinf(stages[count])) {
+        return false;
+      }
+    }
+    count++;
+  }
+  double previous{0.0};
+  for (double deadline : stages) {
+    if (deadline > 0.0) {
+      if (deadline <= previous) {
+        return false;
+      }
+      previous = deadline;
+    }
+  }
+  deadlines.reduce = stages[0];
+  deadlines.hold = stages[1];
+  deadlines.stop = stages[2];
+  return true;
+}
+
+// A pedal position from 0 to 1, e.g. "0.05". Gives false, and leaves pedal
+// as it is, unless the whole value is such a number.
+inline bool pedalFrom(std::string const &value, float &pedal) {
+  size_t end{0};
+  float position{0.0f};
+  try {
+    position = std::stof(value, &end);
+  } catch (std::exception const &) {
+    return false;
+  }
+  if (end != value.size() || !(position >= 0.0f && position <= 1.0f)) {
+    return false;
+  }
+  pedal = position;
+  return true;
+}
+
+// The sample time of the latest message of an input. The receiving thread
+// stores it and the control loop reads it, without a lock.
+class InputAge {
+ private:
+  InputAge(InputAge const &) = delete;
+  InputAge(InputAge &&) = delete;
+  InputAge &operator=(InputAge const &) = delete;
+  InputAge &operator=(InputAge &&) = delete;
+
+ public:
+  InputAge() noexcept
+    : m_sampleUs{0}
+  {
+  }
+
+  // The detectors stamp their messages with the time of the camera frame.
+  // A sample time that is unset or ahead of the receiver's clock is replaced
+  // by the time of receipt.
+  void received(cluon::data::Envelope const &envelope) noexcept {
+    int64_t const nowUs{cluon::time::toMicroseconds(cluon::time::now())};
+    int64_t const sampleUs{cluon::time::toMicroseconds(envelope.sampleTimeStamp())};
+    m_sampleUs.store((sampleUs > 0 && sampleUs <= nowUs) ? sampleUs : nowUs, std::memory_order_release);
+  }
+
+  // In ms; infinite before the first message.
+  double age(int64_t nowUs) const noexcept {
+    int64_t const sampleUs{m_sampleUs.load(std::memory_order_acquire)};
+    if (sampleUs == 0) {
+      return std::numeric_limits<double>::infinity();
+    }
+    return static_cast<double>(std::max<int64_t>(nowUs - sampleUs, 0)) / 1000.0;
+  }
+
+ private:
+  std::atomic<int64_t> m_sampleUs;
+};
+
+// Applies a degradation to the requests of a tick. Only the control loop
+// uses it.
+class DegradationPolicy {
+ public:
+  using Requests = std::pair<opendlv::proxy::GroundSteeringRequest, opendlv::proxy::PedalPositionRequest>;
+
+  explicit DegradationPolicy(float reducedPedal) noexcept
+    : m_reducedPedal{reducedPedal}
+    , m_lastFresh{}
+  {
+  }
+
+  // Whether the controller should run on this tick at all.
+  static bool runsController(Degradation degradation) noexcept {
+    return degradation == Degradation::None || degradation == Degradation::Reduced;
+  }
+
+  // The requests to send; request is the controller's output if it ran.
+  Requests apply(Degradation degradation, Requests const &request) noexcept {
+    Requests result{request};
+    switch (degradation) {
+      case Degradation::None:
+        m_lastFresh = request;
+        break;
+      case Degradation::Reduced:
+        capPedal(result);
+        break;
+      case Degradation::Hold:
+        result = m_lastFresh;
+        capPedal(result);
+        break;
+      case Degradation::Stop:
+        result.first.groundSteering(0.0f);
+        result.second.position(0.0f);
+        break;
+    }
+    return result;
+  }
+
+ private:
+  void capPedal(Requests &request) const noexcept {
+    request.second.position(std::min(request.second.position(), m_reducedPedal));
+  }
+
+  float const m_reducedPedal;
+  Requests m_lastFresh;
+};
+
+#endif
@@ -18,6 +18,14 @@
 
 #include "cluon-complete.hpp"
 #include "opendlv-standard-message-set.hpp"
+#include "od4-bus.hpp"
+#include "logic-controller.hpp"
+#include "perception-arrays.hpp"
+#include "perception-watchdog.hpp"
+#include "scheduling.hpp"
+#include "async-log.hpp"
+#include "metrics.hpp"
+#include "metrics-server.hpp"
 
 // Struct to hold the data
 struct Data {
@@ -25,32 +33,97 @@ struct Data {
   opendlv::perception::KiwiBoundingBox kiwiBoundingBox{};
   std::mutex nearFarPointsMutex{};
   std::mutex kiwiBoundingBoxMutex{};
-  float previousCrossProduct{};
-  int32_t previousNearX{};
-  int32_t previousNearY{};
-  opendlv::proxy::GroundSteeringRequest previousGroundSteeringRequest{};
-  opendlv::proxy::PedalPositionRequest previousPedalPositionRequest{};
+  InputAge nearFarPointsAge{};
+  InputAge kiwiBoundingBoxAge{};
+  LogicController controller{};
+};
+
+// What the control loop reports, for --metrics-port.
+struct ControlMetrics {
+  explicit ControlMetrics(Metrics &metrics)
+    : ticks(metrics.counter("logic_control_ticks_total", "Control ticks run"))
+    , kiwiFollowingTicks(metrics.counter("logic_control_kiwi_following_ticks_total", "Ticks that slowed down for a Kiwi ahead"))
+    , periodErrors(metrics.histogram("logic_control_period_error_ms", "Deviation of the time between two ticks from the period"))
+    , tickDurations(metrics.histogram("logic_control_tick_duration_ms", "Time to compute and send the requests of a tick"))
+    , udpRate(metrics.gauge("logic_control_udp_datagrams_per_second", "UDP datagrams received on the OD4 session (with --udp-batch)"))
+    , udpDrops(metrics.counter("logic_control_udp_drops_total", "UDP datagrams dropped by the kernel as the socket buffer was full (with --udp-batch)"))
+    , deliveredMessages(metrics.counter("logic_control_messages_delivered_total", "Messages handed to a data trigger (with --udp-batch or --shm-bus)"))
+    , filteredMessages(metrics.counter("logic_control_messages_filtered_total", "Messages dropped undecoded as nothing subscribed to them (with --udp-batch or --shm-bus)"))
+    , droppedLogRecords(metrics.counter("logic_control_log_records_dropped_total", "Log records dropped as the log ring was full"))
+    , coneAges(metrics.histogram("logic_control_cone_age_ms", "Age of the latest cones at a tick, from their sample time"))
+    , kiwiAges(metrics.histogram("logic_control_kiwi_age_ms", "Age of the latest Kiwi boxes at a tick, from their sample time"))
+    , coneDeadlineMisses(metrics.counter("logic_control_cone_deadline_misses_total", "Ticks on which the cones were older than their first deadline"))
+    , kiwiDeadlineMisses(metrics.counter("logic_control_kiwi_deadline_misses_total", "Ticks on which the Kiwi boxes were older than their first deadline"))
+    , degradedTicks(metrics.counter("logic_control_degraded_ticks_total", "Ticks with reduced speed, held or stopped for late inputs"))
+    , degradation(metrics.gauge("logic_control_degradation", "Current degradation: 0 none, 1 reduced speed, 2 hold, 3 stop"))
+    , overruns(metrics.counter("logic_control_tick_overruns_total", "Ticks that overran their period"))
+  {
+  }
+
+  Counter &ticks;
+  Counter &kiwiFollowingTicks;
+  Histogram &periodErrors;
+  Histogram &tickDurations;
+  Gauge &udpRate;
+  Counter &udpDrops;
+  Counter &deliveredMessages;
+  Counter &filteredMessages;
+  Counter &droppedLogRecords;
+  Histogram &coneAges;
+  Histogram &kiwiAges;
+  Counter &coneDeadlineMisses;
+  Counter &kiwiDeadlineMisses;
+  Counter &degradedTicks;
+  Gauge &degradation;
+  Counter &overruns;
 };
 
 // Main function
 int32_t main(int32_t argc, char **argv) {
   int32_t retCode{0};
   auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+  Deadlines coneDeadlines;
+  Deadlines kiwiDeadlines;
+  float degradedPedal{0.05f};
+  bool const hasValidDeadlines{
+    (commandlineArguments.count("cone-deadlines") == 0 || deadlinesFrom(commandlineArguments["cone-deadlines"], coneDeadlines))
+      && (commandlineArguments.count("kiwi-deadlines") == 0 || deadlinesFrom(commandlineArguments["kiwi-deadlines"], kiwiDeadlines))
+      && (commandlineArguments.count("degraded-pedal") == 0 || pedalFrom(commandlineArguments["degraded-pedal"], degradedPedal))};
   if (0 == commandlineArguments.count("cid") 
-      || 0 == commandlineArguments.count("freq")) {
+      || 0 == commandlineArguments.count("freq")
+      || !hasValidDeadlines) {
     std::cerr << argv[0] << " The control program for the kiwi car" << std::endl;
+    std::cerr << "         --legacy-messages: take NearFarPoints and KiwiBoundingBox instead of ConeArray and KiwiBoundingBoxArray" << std::endl;
+    std::cerr << "         --shm-bus: exchange messages with local services over shared memory (UDP is kept)" << std::endl;
+    std::cerr << "         --udp-batch: read UDP with several datagrams per system call" << std::endl;
+    std::cerr << "         --cone-deadlines: <reduce>,<hold>,<stop> ages in ms of the cones after which to reduce the speed, repeat the last good requests, or stop (numbers of at least 0, increasing; 0 leaves a stage out; default off)" << std::endl;
+    std::cerr << "         --kiwi-deadlines: the same for the Kiwi boxes" << std::endl;
+    std::cerr << "         --degraded-pedal: highest pedal position at reduced speed and on hold (0 to 1, default 0.05)" << std::endl;
+    std::cerr << "         --metrics-port: serve the metrics on this TCP port (Prometheus text format, or JSON for /metrics.json)" << std::endl;
+    std::cerr << "         --cpus: run on these cores only, e.g. 2-3 or 0,2" << std::endl;
+    std::cerr << "         --rt-priority: run the control loop with SCHED_FIFO at this priority (1 to 99; needs CAP_SYS_NICE)" << std::endl;
+    std::cerr << "         --scheduling-config: file with the settings above for all services (<service>.cpus=..., <service>.threads=..., <service>.rt-priority=...); the flags take precedence" << std::endl;
     std::cerr << "Example: " << argv[0] << " --cid=111 --freq=10 " << std::endl;
     retCode = 1;
   } else {
     bool const VERBOSE{commandlineArguments.count("verbose") != 0};
+    bool const SHM_BUS{commandlineArguments.count("shm-bus") != 0};
+    bool const UDP_BATCH{commandlineArguments.count("udp-batch") != 0};
+    bool const LEGACY_MESSAGES{commandlineArguments.count("legacy-messages") != 0};
     uint16_t const CID = std::stoi(commandlineArguments["cid"]);
     float const FREQ = std::stof(commandlineArguments["freq"]);
+    Scheduling const SCHEDULING = schedulingFrom("logic-control", commandlineArguments);
+    Deadlines const CONE_DEADLINES{coneDeadlines};
+    Deadlines const KIWI_DEADLINES{kiwiDeadlines};
+    float const DEGRADED_PEDAL{degradedPedal};
+    pinThread(SCHEDULING.cpus);
  
     Data data;
-    cluon::OD4Session od4(CID);
+    Od4Bus od4(CID, SHM_BUS, UDP_BATCH);
 
     auto onNearFarPointsReading{[&data](cluon::data::Envelope &&envelope)
       {
+        data.nearFarPointsAge.received(envelope);
         auto nearFarPointsReading = 
           cluon::extractMessage<opendlv::perception::cognition::NearFarPoints>(
               std::move(envelope));
@@ -60,6 +133,7 @@ int32_t main(int32_t argc, char **argv) {
 
     auto onKiwiBoundingBox{[&data](cluon::data::Envelope &&envelope)
       {
+        data.kiwiBoundingBoxAge.received(envelope);
         auto kiwiBoundingBox = 
           cluon::extractMessage<opendlv::perception::KiwiBoundingBox>(
               std::move(envelope));
@@ -67,8 +141,35 @@ int32_t main(int32_t argc, char **argv) {
         data.kiwiBoundingBox = kiwiBoundingBox;
       }};
 
-    od4.dataTrigger(opendlv::perception::cognition::NearFarPoints::ID(), onNearFarPointsReading);
-    od4.dataTrigger(opendlv::perception::KiwiBoundingBox::ID(), onKiwiBoundingBox);
+    // A frame's cones and Kiwis each come in one message, so the nearest
+    // Kiwi of the frame is used rather than whichever box came last.
+    auto onConeArray{[&data](cluon::data::Envelope &&envelope)
+      {
+        data.nearFarPointsAge.received(envelope);
+        auto coneArray = 
+          cluon::extractMessage<opendlv::perception::ConeArray>(
+              std::move(envelope));
+        std::lock_guard<std::mutex> const lock(data.nearFarPointsMutex);
+        data.nearFarPoints = nearFarPointsOf(coneArray);
+      }};
+
+    auto onKiwiBoundingBoxArray{[&data](cluon::data::Envelope &&envelope)
+      {
+        data.kiwiBoundingBoxAge.received(envelope);
+        auto kiwis = 
+          cluon::extractMessage<opendlv::perception::KiwiBoundingBoxArray>(
+              std::move(envelope));
+        std::lock_guard<std::mutex> const lock(data.kiwiBoundingBoxMutex);
+        data.kiwiBoundingBox = nearestKiwiBoundingBox(kiwis);
+      }};
+
+    if (LEGACY_MESSAGES) {
+      od4.dataTrigger(opendlv::perception::cognition::NearFarPoints::ID(), onNearFarPointsReading);
+      od4.dataTrigger(opendlv::perception::KiwiBoundingBox::ID(), onKiwiBoundingBox);
+    } else {
+      od4.dataTrigger(opendlv::perception::ConeArray::ID(), onConeArray);
+      od4.dataTrigger(opendlv::perception::KiwiBoundingBoxArray::ID(), onKiwiBoundingBoxArray);
+    }
 
     cluon::data::TimeStamp startTime = cluon::time::now();
     int64_t startTimeUs = cluon::time::toMicroseconds(startTime);
@@ -83,9 +184,51 @@ int32_t main(int32_t argc, char **argv) {
       }
     }
   
+    // Both requests of a tick go out together, encoded into kept buffers.
+    Od4Batch requests{od4};
+
+    // The tick only puts its log records into a ring; they are written out
+    // by the logger's own thread.
+    AsyncLog log{argv[0]};
+    asynclog::Site kiwiSpeedControlLog{"kiwi speed control activated", 1000};
+    asynclog::Site requestLog{"Ground steering is {} and pedal position is {}"};
+    asynclog::Site overrunLog{"Control tick overran its period ({} times in total).", 1000};
+    asynclog::Site degradationLog{"Degradation: {} (cones {} ms, Kiwi boxes {} ms old)."};
+    asynclog::Site statsLog{"UDP: {} datagrams/s, {} in {} calls, {} dropped; messages delivered {}, filtered unread {}"};
+
+    // The tick only updates atomics; the values are read when requested.
+    Metrics metrics;
+    ControlMetrics controlMetrics{metrics};
+    uint16_t const METRICS_PORT{static_cast<uint16_t>((commandlineArguments.count("metrics-port") != 0) ?
+        std::stoi(commandlineArguments["metrics-port"]) : 0)};
+    std::unique_ptr<MetricsServer> metricsServer{(METRICS_PORT > 0) ? new MetricsServer{METRICS_PORT, metrics} : nullptr};
+    if (metricsServer && !metricsServer->valid()) {
+      std::cerr << argv[0] << ": Could not serve the metrics on port " << METRICS_PORT << "." << std::endl;
+    }
+
     // control logic step
-    auto atFrequency{[&VERBOSE, &data, &od4, startTimeUs]() -> bool
+    int64_t lastStatsUs{startTimeUs};
+    double const PERIOD_MS{1000.0 / FREQ};
+    std::unique_ptr<Stopwatch> sinceLastTick;
+    DegradationPolicy degradationPolicy{DEGRADED_PEDAL};
+    Degradation degradation{Degradation::None};
+    auto atFrequency{[&VERBOSE, &SHM_BUS, &UDP_BATCH, &data, &requests, &od4, &lastStatsUs, &log, &kiwiSpeedControlLog,
+      &requestLog, &overrunLog, &degradationLog, &statsLog, &controlMetrics, &sinceLastTick, &PERIOD_MS, &CONE_DEADLINES,
+      &KIWI_DEADLINES, &degradationPolicy, &degradation, startTimeUs]() -> bool
       {
+        Stopwatch const tick;
+        uint64_t const overruns{od4.overruns()};
+        if (overruns > controlMetrics.overruns.value()) {
+          controlMetrics.overruns.add(overruns - controlMetrics.overruns.value());
+          log.log(overrunLog, overruns);
+        }
+        if (sinceLastTick) {
+          controlMetrics.periodErrors.observe(std::fabs(sinceLastTick->elapsed() - PERIOD_MS));
+          sinceLastTick->restart();
+        } else {
+          sinceLastTick.reset(new Stopwatch);
+        }
+
         // you can use this as a timer
         // cluon::data::TimeStamp currentTime = cluon::time::now();
         // int64_t currentTimeUs = cluon::time::toMicroseconds(currentTime);
@@ -94,6 +237,35 @@ int32_t main(int32_t argc, char **argv) {
         //   std::cout << "One minute passed." << std::endl;
         // }
 
+        // How old the inputs are decides how much the controller is trusted;
+        // the worse of the two wins.
+        int64_t const tickUs{cluon::time::toMicroseconds(cluon::time::now())};
+        double const coneAge{data.nearFarPointsAge.age(tickUs)};
+        double const kiwiAge{data.kiwiBoundingBoxAge.age(tickUs)};
+        Degradation const coneDegradation{CONE_DEADLINES.degradation(coneAge)};
+        Degradation const kiwiDegradation{KIWI_DEADLINES.degradation(kiwiAge)};
+        Degradation const tickDegradation{std::max(coneDegradation, kiwiDegradation)};
+        if (coneAge < std::numeric_limits<double>::infinity()) {
+          controlMetrics.coneAges.observe(coneAge);
+        }
+        if (kiwiAge < std::numeric_limits<double>::infinity()) {
+          controlMetrics.kiwiAges.observe(kiwiAge);
+        }
+        if (coneDegradation != Degradation::None) {
+          controlMetrics.coneDeadlineMisses.add();
+        }
+        if (kiwiDegradation != Degradation::None) {
+          controlMetrics.kiwiDeadlineMisses.add();
+        }
+        if (tickDegradation != Degradation::None) {
+          controlMetrics.degradedTicks.add();
+        }
+        if (tickDegradation != degradation) {
+          degradation = tickDegradation;
+          controlMetrics.degradation.set(static_cast<double>(degradation));
+          log.log(degradationLog, degradationName(degradation), coneAge, kiwiAge);
+        }
+
         // read the data
         opendlv::perception::cognition::NearFarPoints nfPointsReading;
         opendlv::perception::KiwiBoundingBox kiwiBoundingBox;
@@ -105,113 +277,54 @@ int32_t main(int32_t argc, char **argv) {
           kiwiBoundingBox = data.kiwiBoundingBox;
         }
 
-        int32_t previousNearX = data.previousNearX;
-        int32_t previousNearY = data.previousNearY;
-        int32_t nearX = nfPointsReading.nearX();
-        int32_t nearY = nfPointsReading.nearY();
-        int32_t farX = nfPointsReading.farX();
-        int32_t farY = nfPointsReading.farY();
-        bool reachCrossRoad = nfPointsReading.reachCrossRoad();
-
-        // use a simple KF to estimate the near point
-        {
-          float ks = 600.0f;  // vehicle speed to displacement vector length
-          float ka = 1.0f;  // steering angle to displacement vector angle
-          float motionVectorLength = ks * data.previousPedalPositionRequest.position();
-          float motionVectorAngle = ka * data.previousGroundSteeringRequest.groundSteering();
-          int32_t predictedNearX = previousNearX - static_cast<int32_t>(motionVectorLength*cos(motionVectorAngle));
-          int32_t predictedNearY = previousNearY - static_cast<int32_t>(motionVectorLength*sin(motionVectorAngle));
-
-          float g = 0.65f;
-          nearX = static_cast<int32_t>(g * nearX + (1.0f-g) * predictedNearX);
-          nearY = static_cast<int32_t>(g * nearY + (1.0f-g) * predictedNearY);
-
-          data.previousNearX = nearX;
-          data.previousNearY = nearY;
-        }
-
-        // controller parameters
-        float kp = 0.20f;
-        float kd = 0.05f;
-
-        float desiredVectorX = (farX + 2*nearX)/2;
-        float desiredVectorY = (farY + 2*nearY)/2;
-        float desiredVectorLength = std::sqrt(desiredVectorX*desiredVectorX + desiredVectorY*desiredVectorY);
-
-        // deal with the NaN value when desiredVectorLength == 0
-        if (desiredVectorLength < 0.01f) {
-            desiredVectorLength = 1.0f;
+        DegradationPolicy::Requests request;
+        if (DegradationPolicy::runsController(degradation)) {
+          request = data.controller.step(nfPointsReading, kiwiBoundingBox);
         }
-
-        float crossProductZ =  1.0f * desiredVectorY/desiredVectorLength - 0.0f * desiredVectorX/desiredVectorLength;
-        float dotProductZ =  1.0f * desiredVectorX/desiredVectorLength - 0.0f * desiredVectorY/desiredVectorLength;
-
-        float pedalPosition = 0.2f;
-        float groundSteeringAngle = 0.0f;
-
-        // lateral control
-        float previousCrossProduct = data.previousCrossProduct;
-        if (farX == 0 && nearX == 0) {
-          groundSteeringAngle = 0.0f;
-        } else if (dotProductZ < 0.0f) {
-          groundSteeringAngle = kp * ((crossProductZ<0.0f)?-1.0f:1.0f) + kd*(crossProductZ-previousCrossProduct);
-        } else {
-          groundSteeringAngle = kp*crossProductZ + kd*(crossProductZ-previousCrossProduct);
+        request = degradationPolicy.apply(degradation, request);
+        opendlv::proxy::GroundSteeringRequest groundSteeringRequest = request.first;
+        opendlv::proxy::PedalPositionRequest pedalPositionRequest = request.second;
+        if (DegradationPolicy::runsController(degradation) && data.controller.isFollowingKiwi()) {
+          log.log(kiwiSpeedControlLog);
+          controlMetrics.kiwiFollowingTicks.add();
         }
-        data.previousCrossProduct = crossProductZ;
-
-        // slow down when a big turn is required
-        pedalPosition = 0.10f*(1.0f - ((groundSteeringAngle<0)?-1.0f:1.0f)*(groundSteeringAngle));
-
-        // longitudinal control (slow down behind Kiwis and at crossings)
-        if (kiwiBoundingBox.nBox() > 0) {
-          uint32_t boxX = kiwiBoundingBox.x();
-          uint32_t boxY = kiwiBoundingBox.y();
-          uint32_t boxW = kiwiBoundingBox.w();
-          uint32_t boxH = kiwiBoundingBox.h();
-          float boxSize = static_cast<float>(boxW * boxH);
-          uint32_t imgW = kiwiBoundingBox.imageWidth();
-          uint32_t imgH = kiwiBoundingBox.imageHeight();
-          float imgSize =  static_cast<float>(imgW*imgH);
-          float maxKiwiSizeAllowed = imgSize/10;
-          if (boxSize > imgSize/100 && fabs(crossProductZ) < 0.15) {
-             pedalPosition = 0.2f*(1.0f - boxSize/maxKiwiSizeAllowed);
-             std::cout << "kiwi speed control activated" << std::endl;
-             //if (boxSize > maxKiwiSizeAllowed) {
-             //  pedalPosition = 0.0f;
-             //}
-          }
-          if (reachCrossRoad && pedalPosition>0.04f) {
-            pedalPosition = 0.04f;
-          }
-          if (boxY!=imgH-1 && reachCrossRoad && boxX+boxW > imgW/2-1 && boxSize > imgSize/20) {
-            pedalPosition = 0.0f;
-          } 
-         }
 
         // send the calculated control input
-        opendlv::proxy::GroundSteeringRequest groundSteeringRequest;
-        groundSteeringRequest.groundSteering(groundSteeringAngle);
-
-        opendlv::proxy::PedalPositionRequest pedalPositionRequest;
-        pedalPositionRequest.position(pedalPosition);
-
         cluon::data::TimeStamp sampleTime = cluon::time::now();
-        od4.send(groundSteeringRequest, sampleTime, 0);
-        od4.send(pedalPositionRequest, sampleTime, 0);
+        requests.add(groundSteeringRequest, sampleTime, 0);
+        requests.add(pedalPositionRequest, sampleTime, 0);
+        requests.send();
+        controlMetrics.ticks.add();
+        controlMetrics.tickDurations.observe(tick.elapsed());
 
         if (VERBOSE) {
-          std::cout << "Ground steering is " << groundSteeringAngle
-            << " and pedal position is " << pedalPosition << std::endl;
+          log.log(requestLog, groundSteeringRequest.groundSteering(), pedalPositionRequest.position());
         }
 
-        data.previousGroundSteeringRequest = groundSteeringRequest;
-        data.previousPedalPositionRequest = pedalPositionRequest;
+        int64_t const nowUs = cluon::time::toMicroseconds(sampleTime);
+        if (nowUs - lastStatsUs >= 1000000) {
+          lastStatsUs = nowUs;
+          od4bus::ReceiveStats const udp = od4.receiveStats();
+          od4bus::DeliveryStats const shm = od4.sharedMemoryStats();
+          uint64_t const delivered{udp.delivery.delivered + shm.delivered};
+          uint64_t const filtered{udp.delivery.filtered + shm.filtered};
+          controlMetrics.udpRate.set(udp.datagramsPerSecond);
+          controlMetrics.udpDrops.add(udp.drops - controlMetrics.udpDrops.value());
+          controlMetrics.deliveredMessages.add(delivered - controlMetrics.deliveredMessages.value());
+          controlMetrics.filteredMessages.add(filtered - controlMetrics.filteredMessages.value());
+          controlMetrics.droppedLogRecords.add(log.dropped() - controlMetrics.droppedLogRecords.value());
+          if (VERBOSE && (UDP_BATCH || SHM_BUS)) {
+            log.log(statsLog, udp.datagramsPerSecond, udp.datagrams, udp.calls, udp.drops, delivered, filtered);
+          }
+        }
 
         return true;
 
       }};
 
+    // Only the control loop runs in real time; the receiving threads were
+    // started before and keep normal scheduling.
+    setRealtimePriority(SCHEDULING.priority);
     od4.timeTrigger(FREQ, atFrequency);
   }
   return retCode;
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cluon-complete.hpp"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+int32_t main(int32_t argc, char **argv) {
+  int32_t retCode{1};
+  auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+  if ( (0 == commandlineArguments.count("cid")) ||
+       (0 == commandlineArguments.count("name")) ||
+       (0 == commandlineArguments.count("width")) ||
+       (0 == commandlineArguments.count("height")) ) {
+    std::cerr << argv[0] << " attaches to a shared memory area containing an ARGB image and prepares it once for all detectors." << std::endl;
+    std::cerr << "Usage:   " << argv[0] << " --cid=<OD4 session> --name=<name of shared memory area> --width=<w> --height=<h> [--yolo-size=<n>] [--verbose]" << std::endl;
+    std::cerr << "         --cid:       CID of the OD4Session the camera belongs to" << std::endl;
+    std::cerr << "         --name:      name of the shared memory area to attach" << std::endl;
+    std::cerr << "         --width:     width of the frame" << std::endl;
+    std::cerr << "         --height:    height of the frame" << std::endl;
+    std::cerr << "         --yolo-size: side of the square network input (default 320)" << std::endl;
+    std::cerr << "The following shared memory areas are created:" << std::endl;
+    std::cerr << "         <name>.lower: lower half of the frame (BGRA, width x height/2)" << std::endl;
+    std::cerr << "         <name>.hsv:   lower half of the frame (HSV, width x height/2)" << std::endl;
+    std::cerr << "         <name>.half:  frame at half resolution (BGRA, width/2 x height/2)" << std::endl;
+    std::cerr << "         <name>.yolo:  network input (BGR, yolo-size x yolo-size)" << std::endl;
+    std::cerr << "Example: " << argv[0] << " --cid=111 --name=video0.argb --width=1280 --height=720" << std::endl;
+  }
+  else {
+    const std::string NAME{commandlineArguments["name"]};
+    const uint32_t WIDTH{static_cast<uint32_t>(std::stoi(commandlineArguments["width"]))};
+    const uint32_t HEIGHT{static_cast<uint32_t>(std::stoi(commandlineArguments["height"]))};
+    const uint32_t YOLO_SIZE{(commandlineArguments.count("yolo-size") != 0) ?
+      static_cast<uint32_t>(std::stoi(commandlineArguments["yolo-size"])) : 320};
+    const bool VERBOSE{commandlineArguments.count("verbose") != 0};
+
+    // Attach to the shared memory.
+    std::unique_ptr<cluon::SharedMemory> sharedMemory{new cluon::SharedMemory{NAME}};
+    if (sharedMemory && sharedMemory->valid()) {
+      std::clog << argv[0] << ": Attached to shared memory '" << sharedMemory->name() << " (" << sharedMemory->size() << " bytes)." << std::endl;
+
+      // The same region as ConeDetector::regionOfInterest().
+      cv::Rect const lowerHalf(0, HEIGHT/2-1, WIDTH, HEIGHT/2);
+
+      std::unique_ptr<cluon::SharedMemory> lowerMemory{new cluon::SharedMemory{NAME + ".lower", WIDTH * HEIGHT/2 * 4}};
+      std::unique_ptr<cluon::SharedMemory> hsvMemory{new cluon::SharedMemory{NAME + ".hsv", WIDTH * HEIGHT/2 * 3}};
+      std::unique_ptr<cluon::SharedMemory> halfMemory{new cluon::SharedMemory{NAME + ".half", WIDTH/2 * HEIGHT/2 * 4}};
+      std::unique_ptr<cluon::SharedMemory> yoloMemory{new cluon::SharedMemory{NAME + ".yolo", YOLO_SIZE * YOLO_SIZE * 3}};
+      if (!lowerMemory->valid() || !hsvMemory->valid() || !halfMemory->valid() || !yoloMemory->valid()) {
+        std::cerr << argv[0] << ": Failed to create the shared memory areas for '" << NAME << "'." << std::endl;
+        return retCode;
+      }
+
+      // Only used to end the program together with the session.
+      cluon::OD4Session od4{static_cast<uint16_t>(std::stoi(commandlineArguments["cid"]))};
+
+      // Writes one product straight into its area and wakes its consumers.
+      auto publish{[](cluon::SharedMemory &area, cluon::data::TimeStamp const &sampleTime, int32_t rows, int32_t cols, int32_t type, auto &&produce) {
+          area.lock();
+          {
+            // The destination already has the right size and type, so
+            // OpenCV writes into the shared memory without reallocating.
+            cv::Mat wrapped(rows, cols, type, area.data());
+            produce(wrapped);
+            area.setTimeStamp(sampleTime);
+          }
+          area.unlock();
+          area.notifyAll();
+        }};
+
+      // Endless loop; end the program by pressing Ctrl-C.
+      while (od4.isRunning()) {
+        cv::Mat imga;
+        cluon::data::TimeStamp sampleTime;
+
+        // Wait for a notification of a new frame.
+        sharedMemory->wait();
+
+        // The frame is copied once here, instead of once per detector.
+        sharedMemory->lock();
+        {
+          cv::Mat wrapped(HEIGHT, WIDTH, CV_8UC4, sharedMemory->data());
+          imga = wrapped.clone();
+          sampleTime = sharedMemory->getTimeStamp().second;
+        }
+        sharedMemory->unlock();
+
+        cv::Mat const lower = imga(lowerHalf);
+
+        publish(*lowerMemory, sampleTime, HEIGHT/2, WIDTH, CV_8UC4, [&lower](cv::Mat &dst) {
+            lower.copyTo(dst);
+          });
+
+        publish(*halfMemory, sampleTime, HEIGHT/2, WIDTH/2, CV_8UC4, [&imga](cv::Mat &dst) {
+            cv::resize(imga, dst, dst.size(), 0, 0, cv::INTER_AREA);
+          });
+
+        // Same result as cvtColor followed by the resize in blobFromImage,
+        // but the alpha channel is dropped after shrinking the frame.
+        publish(*yoloMemory, sampleTime, YOLO_SIZE, YOLO_SIZE, CV_8UC3, [&imga](cv::Mat &dst) {
+            cv::Mat resized;
+            cv::resize(imga, resized, dst.size(), 0, 0, cv::INTER_LINEAR);
+            cv::cvtColor(resized, dst, cv::COLOR_RGBA2RGB);
+          });
+
+        publish(*hsvMemory, sampleTime, HEIGHT/2, WIDTH, CV_8UC3, [&lower](cv::Mat &dst) {
+            cv::cvtColor(lower, dst, cv::COLOR_BGR2HSV);
+          });
+
+        if (VERBOSE) {
+          int64_t const latency{cluon::time::deltaInMicroseconds(cluon::time::now(), sampleTime)};
+          std::clog << argv[0] << ": Prepared frame in " << latency << " us." << std::endl;
+        }
+      }
+    }
+    retCode = 0;
+  }
+  return retCode;
+}
@@ -0,0 +1,644 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RECORDING_HPP
+#define RECORDING_HPP
+
+#include "cluon-complete.hpp"
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgcodecs/imgcodecs.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The layout of a recording. All values are little endian (as the host),
+// and every structure and record starts at a multiple of 8 bytes, so that
+// the file can be read in place once mapped.
+//
+//   FileHeader
+//   chunk 0: ChunkHeader, records, IndexEntry per record
+//   chunk 1: ...
+//   ChunkEntry per chunk, Trailer
+//
+// A chunk is written as a whole once it is full or old enough, so a
+// recording that was cut off still has all its chunks up to the last one.
+// Without the trailer, the reader walks the chunk headers instead.
+namespace recording {
+
+char const FILE_MAGIC[8] = {'G', '7', 'R', 'E', 'C', '0', '0', '1'};
+char const TRAILER_MAGIC[8] = {'G', '7', 'R', 'E', 'C', 'E', 'N', 'D'};
+uint32_t const CHUNK_MAGIC{0x4b4e4843};  // "CHNK"
+
+enum class RecordKind : uint16_t { ENVELOPE = 1, FRAME = 2 };
+enum class FrameEncoding : uint8_t { BGR = 0, JPEG = 1 };
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+};
+
+struct ChunkHeader {
+  uint32_t magic;
+  uint32_t records;
+  // Of the whole chunk, including this header and the index.
+  uint64_t size;
+  int64_t firstTimeUs;
+  int64_t lastTimeUs;
+  uint64_t firstSequence;
+  // From the start of the chunk.
+  uint64_t indexOffset;
+};
+
+// Followed by size bytes of payload, padded to a multiple of 8. The time is
+// when the recorder got the record; the sequence counts all records.
+struct RecordHeader {
+  uint32_t size;
+  uint16_t kind;
+  uint16_t reserved;
+  int64_t timeUs;
+  uint64_t sequence;
+};
+
+// One per record of a chunk, in order; offset is from the start of the
+// chunk.
+struct IndexEntry {
+  int64_t timeUs;
+  uint64_t offset;
+};
+
+// One per chunk, at the end of the file; offset is from the start of the
+// file.
+struct ChunkEntry {
+  int64_t firstTimeUs;
+  int64_t lastTimeUs;
+  uint64_t firstSequence;
+  uint64_t offset;
+  uint32_t records;
+  uint32_t reserved;
+};
+
+struct Trailer {
+  uint64_t chunks;
+  uint64_t chunkTableOffset;
+  char magic[8];
+};
+
+// The payload of a frame record starts with this header, followed by the
+// pixels of the region (BGR rows) or by the JPEG file.
+struct FrameHeader {
+  int64_t sampleTimeUs;
+  // The region of the camera frame that was recorded, and the frame size.
+  uint16_t x;
+  uint16_t y;
+  uint16_t width;
+  uint16_t height;
+  uint16_t frameWidth;
+  uint16_t frameHeight;
+  uint8_t encoding;
+  uint8_t reserved[3];
+};
+
+inline size_t padded(size_t size) noexcept {
+  return (size + 7) & ~static_cast<size_t>(7);
+}
+
+inline int64_t nowUs() noexcept {
+  return cluon::time::toMicroseconds(cluon::time::now());
+}
+
+}
+
+// Appends the OD4 envelopes and camera frames that it is given to a
+// recording. The caller only queues them; a thread of the writer encodes
+// them (envelopes as in a .rec file, frames as BGR or JPEG), fills the
+// chunk in memory and writes it in one go. What is queued and not yet
+// written is limited to maxPendingBytes; beyond that, new records are
+// dropped and counted, so that a slow disk never holds up the caller.
+class RecordingWriter {
+ private:
+  RecordingWriter(RecordingWriter const &) = delete;
+  RecordingWriter(RecordingWriter &&) = delete;
+  RecordingWriter &operator=(RecordingWriter const &) = delete;
+  RecordingWriter &operator=(RecordingWriter &&) = delete;
+
+  struct Pending {
+    recording::RecordKind kind{recording::RecordKind::ENVELOPE};
+    int64_t timeUs{0};
+    size_t bytes{0};
+    cluon::data::Envelope envelope{};
+    cv::Mat frame{};
+    recording::FrameHeader frameHeader{};
+  };
+
+ public:
+  // jpegQuality 0 keeps the frames as BGR. A chunk is written once it
+  // holds chunkBytes, or maxChunkAgeMs after its first record.
+  RecordingWriter(std::string const &path, int32_t jpegQuality = 0, size_t chunkBytes = 4 * 1024 * 1024,
+      size_t maxPendingBytes = 64 * 1024 * 1024, uint32_t maxChunkAgeMs = 1000)
+    : m_fd{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)}
+    , m_jpegQuality{jpegQuality}
+    , m_chunkBytes{chunkBytes}
+    , m_maxPendingBytes{maxPendingBytes}
+    , m_maxChunkAge{maxChunkAgeMs}
+    , m_mutex{}
+    , m_condition{}
+    , m_pending{}
+    , m_pendingBytes{0}
+    , m_isRunning{true}
+    , m_chunk{}
+    , m_index{}
+    , m_chunkHeader{}
+    , m_chunkStart{}
+    , m_chunks{}
+    , m_offset{0}
+    , m_sequence{0}
+    , m_encoded{}
+    , m_written{0}
+    , m_dropped{0}
+    , m_bytes{0}
+    , m_hasFailed{false}
+    , m_writer{}
+  {
+    if (m_fd >= 0) {
+      recording::FileHeader header{};
+      std::memcpy(header.magic, recording::FILE_MAGIC, sizeof(header.magic));
+      header.version = 1;
+      m_chunk.reserve(m_chunkBytes + m_chunkBytes / 4);
+      if (writeAll(reinterpret_cast<char const *>(&header), sizeof(header))) {
+        m_writer = std::thread{&RecordingWriter::run, this};
+      }
+    }
+  }
+
+  // Writes what is still queued, the last chunk and the chunk table. After
+  // a write error, the file is left as it is.
+  ~RecordingWriter() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_isRunning = false;
+    }
+    m_condition.notify_all();
+    if (m_writer.joinable()) {
+      m_writer.join();
+    }
+    if (m_fd >= 0 && !m_hasFailed.load(std::memory_order_relaxed)) {
+      sealChunk();
+    }
+    if (m_fd >= 0 && !m_hasFailed.load(std::memory_order_relaxed)) {
+      recording::Trailer trailer{};
+      trailer.chunks = m_chunks.size();
+      trailer.chunkTableOffset = m_offset;
+      std::memcpy(trailer.magic, recording::TRAILER_MAGIC, sizeof(trailer.magic));
+      writeAll(reinterpret_cast<char const *>(m_chunks.data()), m_chunks.size() * sizeof(recording::ChunkEntry));
+      writeAll(reinterpret_cast<char const *>(&trailer), sizeof(trailer));
+    }
+    if (m_fd >= 0) {
+      ::close(m_fd);
+    }
+  }
+
+  // False if the file could not be opened, or once a write failed.
+  bool valid() const noexcept {
+    return m_fd >= 0 && !m_hasFailed.load(std::memory_order_relaxed);
+  }
+
+  bool addEnvelope(cluon::data::Envelope &&envelope) {
+    Pending pending;
+    pending.kind = recording::RecordKind::ENVELOPE;
+    pending.bytes = sizeof(recording::RecordHeader) + envelope.serializedData().size() + 64;
+    pending.envelope = std::move(envelope);
+    return enqueue(std::move(pending));
+  }
+
+  // bgr is the region roi of a camera frame of frameSize, taken over by the
+  // writer.
+  bool addFrame(cv::Mat &&bgr, cv::Rect const &roi, cv::Size const &frameSize, cluon::data::TimeStamp const &sampleTime) {
+    Pending pending;
+    pending.kind = recording::RecordKind::FRAME;
+    pending.bytes = sizeof(recording::RecordHeader) + sizeof(recording::FrameHeader) + bgr.total() * bgr.elemSize();
+    pending.frameHeader.sampleTimeUs = cluon::time::toMicroseconds(sampleTime);
+    pending.frameHeader.x = static_cast<uint16_t>(roi.x);
+    pending.frameHeader.y = static_cast<uint16_t>(roi.y);
+    pending.frameHeader.width = static_cast<uint16_t>(roi.width);
+    pending.frameHeader.height = static_cast<uint16_t>(roi.height);
+    pending.frameHeader.frameWidth = static_cast<uint16_t>(frameSize.width);
+    pending.frameHeader.frameHeight = static_cast<uint16_t>(frameSize.height);
+    pending.frameHeader.encoding = static_cast<uint8_t>((m_jpegQuality > 0) ?
+        recording::FrameEncoding::JPEG : recording::FrameEncoding::BGR);
+    pending.frame = std::move(bgr);
+    return enqueue(std::move(pending));
+  }
+
+  // Records written to the file (or to the chunk in memory).
+  uint64_t written() const noexcept {
+    return m_written.load(std::memory_order_relaxed);
+  }
+
+  // Records dropped as too much was queued, or after a write error.
+  uint64_t dropped() const noexcept {
+    return m_dropped.load(std::memory_order_relaxed);
+  }
+
+  // Bytes written to the file.
+  uint64_t bytes() const noexcept {
+    return m_bytes.load(std::memory_order_relaxed);
+  }
+
+ private:
+  bool enqueue(Pending &&pending) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_isRunning || m_fd < 0 || m_pendingBytes + pending.bytes > m_maxPendingBytes) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      // Taken under the lock, so the times grow with the sequence.
+      pending.timeUs = recording::nowUs();
+      m_pendingBytes += pending.bytes;
+      m_pending.push_back(std::move(pending));
+    }
+    m_condition.notify_one();
+    return true;
+  }
+
+  void run() {
+    while (true) {
+      Pending pending;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        bool const hasChunk{m_chunkHeader.records > 0};
+        auto const isReady{[this]() { return !m_pending.empty() || !m_isRunning; }};
+        if (hasChunk) {
+          m_condition.wait_until(lock, m_chunkStart + m_maxChunkAge, isReady);
+        } else {
+          m_condition.wait(lock, isReady);
+        }
+        if (m_pending.empty()) {
+          if (!m_isRunning) {
+            return;
+          }
+          lock.unlock();
+          // The chunk is old enough.
+          sealChunk();
+          continue;
+        }
+        pending = std::move(m_pending.front());
+        m_pending.pop_front();
+        m_pendingBytes -= pending.bytes;
+      }
+      append(pending);
+      if (m_chunk.size() >= m_chunkBytes || std::chrono::steady_clock::now() - m_chunkStart >= m_maxChunkAge) {
+        sealChunk();
+      }
+    }
+  }
+
+  void append(Pending &pending) {
+    if (m_chunkHeader.records == 0) {
+      m_chunk.assign(sizeof(recording::ChunkHeader), '\0');
+      m_chunkHeader.firstTimeUs = pending.timeUs;
+      m_chunkHeader.firstSequence = m_sequence;
+      m_chunkStart = std::chrono::steady_clock::now();
+    }
+
+    // The payload is built in m_encoded, then copied into the chunk after
+    // the record header.
+    m_encoded.clear();
+    if (pending.kind == recording::RecordKind::ENVELOPE) {
+      m_encoded = cluon::serializeEnvelope(std::move(pending.envelope));
+    } else {
+      m_encoded.append(reinterpret_cast<char const *>(&pending.frameHeader), sizeof(pending.frameHeader));
+      if (m_jpegQuality > 0) {
+        std::vector<uint8_t> jpeg;
+        cv::imencode(".jpg", pending.frame, jpeg, std::vector<int32_t>{cv::IMWRITE_JPEG_QUALITY, m_jpegQuality});
+        m_encoded.append(reinterpret_cast<char const *>(jpeg.data()), jpeg.size());
+      } else {
+        cv::Mat const continuous{pending.frame.isContinuous() ? pending.frame : pending.frame.clone()};
+        m_encoded.append(reinterpret_cast<char const *>(continuous.data), continuous.total() * continuous.elemSize());
+      }
+    }
+
+    recording::RecordHeader header{};
+    header.size = static_cast<uint32_t>(m_encoded.size());
+    header.kind = static_cast<uint16_t>(pending.kind);
+    header.timeUs = pending.timeUs;
+    header.sequence = m_sequence++;
+    m_index.push_back(recording::IndexEntry{pending.timeUs, m_chunk.size()});
+    m_chunk.append(reinterpret_cast<char const *>(&header), sizeof(header));
+    m_chunk.append(m_encoded);
+    m_chunk.resize(recording::padded(m_chunk.size()), '\0');
+    m_chunkHeader.records++;
+    m_chunkHeader.lastTimeUs = pending.timeUs;
+    m_written.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Adds the index and the header to the chunk in memory and writes it.
+  void sealChunk() {
+    if (m_chunkHeader.records == 0) {
+      return;
+    }
+    m_chunkHeader.magic = recording::CHUNK_MAGIC;
+    m_chunkHeader.indexOffset = m_chunk.size();
+    m_chunk.append(reinterpret_cast<char const *>(m_index.data()), m_index.size() * sizeof(recording::IndexEntry));
+    m_chunkHeader.size = m_chunk.size();
+    std::memcpy(&m_chunk[0], &m_chunkHeader, sizeof(m_chunkHeader));
+
+    recording::ChunkEntry const entry{m_chunkHeader.firstTimeUs, m_chunkHeader.lastTimeUs,
+        m_chunkHeader.firstSequence, m_offset, m_chunkHeader.records, 0};
+    if (writeAll(m_chunk.data(), m_chunk.size())) {
+      m_chunks.push_back(entry);
+    } else {
+      m_written.fetch_sub(m_chunkHeader.records, std::memory_order_relaxed);
+      m_dropped.fetch_add(m_chunkHeader.records, std::memory_order_relaxed);
+    }
+
+    m_chunk.clear();
+    m_index.clear();
+    m_chunkHeader = recording::ChunkHeader{};
+  }
+
+  // On an error, the writer stops: what is queued and what comes later is
+  // dropped, as the offsets in the file are no longer known.
+  bool writeAll(char const *data, size_t size) {
+    size_t done{0};
+    while (done < size) {
+      ssize_t const n{::write(m_fd, data + done, size - done)};
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        std::cerr << "Could not write the recording: " << std::strerror(errno) << std::endl;
+        fail();
+        return false;
+      }
+      done += static_cast<size_t>(n);
+    }
+    m_offset += size;
+    m_bytes.store(m_offset, std::memory_order_relaxed);
+    return true;
+  }
+
+  void fail() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_hasFailed.store(true, std::memory_order_relaxed);
+    m_isRunning = false;
+    m_dropped.fetch_add(m_pending.size(), std::memory_order_relaxed);
+    m_pending.clear();
+    m_pendingBytes = 0;
+  }
+
+  int32_t const m_fd;
+  int32_t const m_jpegQuality;
+  size_t const m_chunkBytes;
+  size_t const m_maxPendingBytes;
+  std::chrono::milliseconds const m_maxChunkAge;
+
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::deque<Pending> m_pending;
+  size_t m_pendingBytes;
+  bool m_isRunning;
+
+  // Only used by the writer thread (and the destructor after it stopped).
+  std::string m_chunk;
+  std::vector<recording::IndexEntry> m_index;
+  recording::ChunkHeader m_chunkHeader;
+  std::chrono::steady_clock::time_point m_chunkStart;
+  std::vector<recording::ChunkEntry> m_chunks;
+  uint64_t m_offset;
+  uint64_t m_sequence;
+  std::string m_encoded;
+
+  std::atomic<uint64_t> m_written;
+  std::atomic<uint64_t> m_dropped;
+  std::atomic<uint64_t> m_bytes;
+  std::atomic<bool> m_hasFailed;
+  std::thread m_writer;
+};
+
+// A record as it lies in the mapped file.
+struct RecordView {
+  recording::RecordKind kind{recording::RecordKind::ENVELOPE};
+  int64_t timeUs{0};
+  uint64_t sequence{0};
+  char const *data{nullptr};
+  size_t size{0};
+};
+
+// Reads a recording in place from a read-only mapping. Finding the first
+// record at or after a time is two binary searches, one over the chunk
+// table and one over the index of the chunk, so a replay can start
+// anywhere in a long recording without reading what comes before.
+class RecordingReader {
+ private:
+  RecordingReader(RecordingReader const &) = delete;
+  RecordingReader(RecordingReader &&) = delete;
+  RecordingReader &operator=(RecordingReader const &) = delete;
+  RecordingReader &operator=(RecordingReader &&) = delete;
+
+ public:
+  // A record by its chunk and its number within the chunk.
+  struct Position {
+    size_t chunk{0};
+    uint32_t record{0};
+  };
+
+  explicit RecordingReader(std::string const &path) noexcept
+    : m_data{nullptr}
+    , m_size{0}
+    , m_chunks{}
+  {
+    int32_t const fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd < 0) {
+      return;
+    }
+    struct stat fileStatus;
+    if (0 == ::fstat(fd, &fileStatus) && static_cast<size_t>(fileStatus.st_size) >= sizeof(recording::FileHeader)) {
+      void *data = ::mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_SHARED, fd, 0);
+      if (data != MAP_FAILED) {
+        m_data = static_cast<char const *>(data);
+        m_size = static_cast<size_t>(fileStatus.st_size);
+        // Seeks jump around; only what is read is paged in.
+        ::madvise(data, m_size, MADV_RANDOM);
+      }
+    }
+    ::close(fd);
+    if (m_data != nullptr && (std::memcmp(m_data, recording::FILE_MAGIC, sizeof(recording::FILE_MAGIC)) != 0
+          || !readChunkTable())) {
+      ::munmap(const_cast<char *>(m_data), m_size);
+      m_data = nullptr;
+    }
+  }
+
+  ~RecordingReader() {
+    if (m_data != nullptr) {
+      ::munmap(const_cast<char *>(m_data), m_size);
+    }
+  }
+
+  bool valid() const noexcept {
+    return m_data != nullptr;
+  }
+
+  size_t records() const noexcept {
+    size_t records{0};
+    for (auto const &chunk : m_chunks) {
+      records += chunk.records;
+    }
+    return records;
+  }
+
+  int64_t firstTimeUs() const noexcept {
+    return m_chunks.empty() ? 0 : m_chunks.front().firstTimeUs;
+  }
+
+  int64_t lastTimeUs() const noexcept {
+    return m_chunks.empty() ? 0 : m_chunks.back().lastTimeUs;
+  }
+
+  Position begin() const noexcept {
+    return Position{};
+  }
+
+  // The first record at or after timeUs, or the end.
+  Position seek(int64_t timeUs) const noexcept {
+    auto const chunk{std::lower_bound(m_chunks.begin(), m_chunks.end(), timeUs,
+        [](recording::ChunkEntry const &entry, int64_t t) { return entry.lastTimeUs < t; })};
+    Position position;
+    position.chunk = static_cast<size_t>(chunk - m_chunks.begin());
+    if (chunk != m_chunks.end()) {
+      recording::IndexEntry const *index{chunkIndex(*chunk)};
+      auto const entry{std::lower_bound(index, index + chunk->records, timeUs,
+          [](recording::IndexEntry const &e, int64_t t) { return e.timeUs < t; })};
+      position.record = static_cast<uint32_t>(entry - index);
+    }
+    return position;
+  }
+
+  // The record at position, which then moves on to the next one; false at
+  // the end.
+  bool read(Position &position, RecordView &record) const noexcept {
+    while (position.chunk < m_chunks.size() && position.record >= m_chunks[position.chunk].records) {
+      position.chunk++;
+      position.record = 0;
+    }
+    if (position.chunk >= m_chunks.size()) {
+      return false;
+    }
+    recording::ChunkEntry const &chunk{m_chunks[position.chunk]};
+    recording::IndexEntry entry;
+    std::memcpy(&entry, chunkIndex(chunk) + position.record, sizeof(entry));
+    recording::RecordHeader header;
+    std::memcpy(&header, m_data + chunk.offset + entry.offset, sizeof(header));
+    record.kind = static_cast<recording::RecordKind>(header.kind);
+    record.timeUs = header.timeUs;
+    record.sequence = header.sequence;
+    record.data = m_data + chunk.offset + entry.offset + sizeof(header);
+    record.size = header.size;
+    position.record++;
+    return true;
+  }
+
+  // The envelope of an ENVELOPE record.
+  static bool envelope(RecordView const &record, cluon::data::Envelope &envelope) {
+    std::stringstream sstr{std::string(record.data, record.size)};
+    auto result{cluon::extractEnvelope(sstr)};
+    envelope = std::move(result.second);
+    return result.first;
+  }
+
+  // The header and the BGR pixels of a FRAME record. Raw frames are
+  // wrapped, not copied, so they are only valid while the reader is.
+  static bool frame(RecordView const &record, recording::FrameHeader &header, cv::Mat &bgr) {
+    if (record.kind != recording::RecordKind::FRAME || record.size < sizeof(header)) {
+      return false;
+    }
+    std::memcpy(&header, record.data, sizeof(header));
+    char const *pixels{record.data + sizeof(header)};
+    size_t const size{record.size - sizeof(header)};
+    if (header.encoding == static_cast<uint8_t>(recording::FrameEncoding::JPEG)) {
+      cv::Mat const jpeg(1, static_cast<int32_t>(size), CV_8UC1, const_cast<char *>(pixels));
+      bgr = cv::imdecode(jpeg, cv::IMREAD_COLOR);
+    } else if (size == static_cast<size_t>(header.width) * header.height * 3) {
+      bgr = cv::Mat(header.height, header.width, CV_8UC3, const_cast<char *>(pixels));
+    } else {
+      return false;
+    }
+    return !bgr.empty();
+  }
+
+ private:
+  recording::IndexEntry const *chunkIndex(recording::ChunkEntry const &chunk) const noexcept {
+    recording::ChunkHeader header;
+    std::memcpy(&header, m_data + chunk.offset, sizeof(header));
+    return reinterpret_cast<recording::IndexEntry const *>(m_data + chunk.offset + header.indexOffset);
+  }
+
+  // From the trailer, or, for a recording that was cut off or is still
+  // being written, by walking the chunk headers.
+  bool readChunkTable() {
+    if (m_size >= sizeof(recording::FileHeader) + sizeof(recording::Trailer)) {
+      recording::Trailer trailer;
+      std::memcpy(&trailer, m_data + m_size - sizeof(trailer), sizeof(trailer));
+      if (std::memcmp(trailer.magic, recording::TRAILER_MAGIC, sizeof(trailer.magic)) == 0
+          && trailer.chunkTableOffset + trailer.chunks * sizeof(recording::ChunkEntry) + sizeof(trailer) == m_size) {
+        m_chunks.resize(trailer.chunks);
+        std::memcpy(m_chunks.data(), m_data + trailer.chunkTableOffset, trailer.chunks * sizeof(recording::ChunkEntry));
+        return true;
+      }
+    }
+
+    uint64_t offset{sizeof(recording::FileHeader)};
+    while (offset + sizeof(recording::ChunkHeader) <= m_size) {
+      recording::ChunkHeader header;
+      std::memcpy(&header, m_data + offset, sizeof(header));
+      if (header.magic != recording::CHUNK_MAGIC || header.size < sizeof(header) || offset + header.size > m_size
+          || header.indexOffset + header.records * sizeof(recording::IndexEntry) > header.size) {
+        break;
+      }
+      m_chunks.push_back(recording::ChunkEntry{header.firstTimeUs, header.lastTimeUs, header.firstSequence,
+          offset, header.records, 0});
+      offset += header.size;
+    }
+    return true;
+  }
+
+  char const *m_data;
+  size_t m_size;
+  std::vector<recording::ChunkEntry> m_chunks;
+};
+
+#endif
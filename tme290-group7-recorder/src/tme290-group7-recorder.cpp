@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cluon-complete.hpp"
+#include "recording.hpp"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// "x,y,width,height", or the whole frame if empty.
+static cv::Rect parseRegion(std::string const &region, uint32_t width, uint32_t height) {
+  cv::Rect const frame(0, 0, static_cast<int32_t>(width), static_cast<int32_t>(height));
+  std::stringstream sstr(region);
+  char comma;
+  int32_t x, y, w, h;
+  if (region.empty() || !(sstr >> x >> comma >> y >> comma >> w >> comma >> h)) {
+    return frame;
+  }
+  return cv::Rect(x, y, w, h) & frame;
+}
+
+int32_t main(int32_t argc, char **argv) {
+  int32_t retCode{1};
+  auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+  if ( (0 == commandlineArguments.count("cid")) ||
+       (0 == commandlineArguments.count("rec")) ||
+       (0 != commandlineArguments.count("name") &&
+        (0 == commandlineArguments.count("width") || 0 == commandlineArguments.count("height"))) ) {
+    std::cerr << argv[0] << " records all messages of an OD4 session and, optionally, the frames of a camera into one indexed file." << std::endl;
+    std::cerr << "Usage:   " << argv[0] << " --cid=<OD4 session> --rec=<file> [--name=<name of shared memory area> --width=<w> --height=<h> [--roi=<x>,<y>,<w>,<h>] [--jpeg-quality=<1..100>] [--frame-interval=<n>]] [--chunk-mb=<n>] [--max-pending-mb=<n>] [--verbose]" << std::endl;
+    std::cerr << "         --cid:            CID of the OD4Session to record" << std::endl;
+    std::cerr << "         --rec:            the recording to write" << std::endl;
+    std::cerr << "         --name:           name of the shared memory area of the camera" << std::endl;
+    std::cerr << "         --width:          width of the frame" << std::endl;
+    std::cerr << "         --height:         height of the frame" << std::endl;
+    std::cerr << "         --roi:            only record this region of the frame (default: the whole frame)" << std::endl;
+    std::cerr << "         --jpeg-quality:   store the frames as JPEG of this quality instead of BGR" << std::endl;
+    std::cerr << "         --frame-interval: only record every n-th frame (default 1)" << std::endl;
+    std::cerr << "         --chunk-mb:       size of the chunks written at once (default 4)" << std::endl;
+    std::cerr << "         --max-pending-mb: memory for records not yet written; beyond, records are dropped (default 64)" << std::endl;
+    std::cerr << "Example: " << argv[0] << " --cid=111 --rec=/tmp/task-2.g7rec --name=video0.argb --width=1280 --height=720 --roi=0,359,1280,360 --jpeg-quality=90" << std::endl;
+  }
+  else {
+    const bool VERBOSE{commandlineArguments.count("verbose") != 0};
+    const bool HAS_CAMERA{commandlineArguments.count("name") != 0};
+    const uint32_t WIDTH{HAS_CAMERA ? static_cast<uint32_t>(std::stoi(commandlineArguments["width"])) : 0};
+    const uint32_t HEIGHT{HAS_CAMERA ? static_cast<uint32_t>(std::stoi(commandlineArguments["height"])) : 0};
+    const cv::Rect ROI{parseRegion(commandlineArguments["roi"], WIDTH, HEIGHT)};
+    const int32_t JPEG_QUALITY{(commandlineArguments.count("jpeg-quality") != 0) ?
+      std::stoi(commandlineArguments["jpeg-quality"]) : 0};
+    const uint32_t FRAME_INTERVAL{(commandlineArguments.count("frame-interval") != 0) ?
+      static_cast<uint32_t>(std::max(std::stoi(commandlineArguments["frame-interval"]), 1)) : 1};
+    const size_t CHUNK_BYTES{static_cast<size_t>((commandlineArguments.count("chunk-mb") != 0) ?
+      std::stod(commandlineArguments["chunk-mb"]) * 1024 * 1024 : 4 * 1024 * 1024)};
+    const size_t MAX_PENDING_BYTES{static_cast<size_t>((commandlineArguments.count("max-pending-mb") != 0) ?
+      std::stod(commandlineArguments["max-pending-mb"]) * 1024 * 1024 : 64 * 1024 * 1024)};
+
+    std::unique_ptr<cluon::SharedMemory> sharedMemory{HAS_CAMERA ? new cluon::SharedMemory{commandlineArguments["name"]} : nullptr};
+    if (sharedMemory && !sharedMemory->valid()) {
+      std::cerr << argv[0] << ": Failed to attach to shared memory '" << commandlineArguments["name"] << "'." << std::endl;
+      return retCode;
+    }
+    if (sharedMemory) {
+      std::clog << argv[0] << ": Attached to shared memory '" << sharedMemory->name() << " (" << sharedMemory->size() << " bytes)." << std::endl;
+    }
+
+    RecordingWriter writer{commandlineArguments["rec"], JPEG_QUALITY, CHUNK_BYTES, MAX_PENDING_BYTES};
+    if (!writer.valid()) {
+      std::cerr << argv[0] << ": Could not create " << commandlineArguments["rec"] << "." << std::endl;
+      return retCode;
+    }
+
+    // Every envelope of the session goes to the writer as it is; it is
+    // encoded on the writer's thread.
+    cluon::OD4Session od4{static_cast<uint16_t>(std::stoi(commandlineArguments["cid"])),
+      [&writer](cluon::data::Envelope &&envelope) {
+        writer.addEnvelope(std::move(envelope));
+      }};
+
+    auto lastReport{std::chrono::steady_clock::now()};
+    auto report{[&writer, &lastReport, &argv]() {
+        auto const now{std::chrono::steady_clock::now()};
+        if (now - lastReport >= std::chrono::seconds(5)) {
+          lastReport = now;
+          std::clog << argv[0] << ": " << writer.written() << " records, " << writer.bytes() / (1024 * 1024)
+            << " MB written, " << writer.dropped() << " dropped." << std::endl;
+        }
+      }};
+
+    // Endless loop; end the program by pressing Ctrl-C. The recording is
+    // completed when the writer goes out of scope. After a write error, the
+    // writer has stopped and so does the program.
+    uint64_t frame{0};
+    while (od4.isRunning() && writer.valid()) {
+      if (!sharedMemory) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      } else {
+        sharedMemory->wait();
+        if (frame++ % FRAME_INTERVAL == 0) {
+          cv::Mat bgr;
+          cluon::data::TimeStamp sampleTime;
+          sharedMemory->lock();
+          {
+            // Only the region is converted out of the camera frame.
+            cv::Mat wrapped(HEIGHT, WIDTH, CV_8UC4, sharedMemory->data());
+            cv::cvtColor(wrapped(ROI), bgr, cv::COLOR_BGRA2BGR);
+            sampleTime = sharedMemory->getTimeStamp().second;
+          }
+          sharedMemory->unlock();
+          writer.addFrame(std::move(bgr), ROI, cv::Size(static_cast<int32_t>(WIDTH), static_cast<int32_t>(HEIGHT)), sampleTime);
+        }
+      }
+      if (VERBOSE) {
+        report();
+      }
+    }
+    if (!writer.valid()) {
+      std::cerr << argv[0] << ": Stopped after a write error, " << writer.dropped() << " records dropped." << std::endl;
+      return retCode;
+    }
+    retCode = 0;
+  }
+  return retCode;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020 Ola Benderius
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cluon-complete.hpp"
+#include "recording.hpp"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+int32_t main(int32_t argc, char **argv) {
+  int32_t retCode{1};
+  auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+  if (0 == commandlineArguments.count("rec")
+      || (0 == commandlineArguments.count("cid") && 0 == commandlineArguments.count("info"))) {
+    std::cerr << argv[0] << " replays a recording of tme290-group7-recorder into an OD4 session and a shared memory area." << std::endl;
+    std::cerr << "Usage:   " << argv[0] << " --rec=<file> --cid=<OD4 session> [--name=<name of shared memory area>] [--start=<s>] [--end=<s>] [--speed=<factor>] [--verbose]" << std::endl;
+    std::cerr << "         " << argv[0] << " --rec=<file> --info" << std::endl;
+    std::cerr << "         --rec:   the recording" << std::endl;
+    std::cerr << "         --cid:   CID of the OD4Session to send the recorded messages to" << std::endl;
+    std::cerr << "         --name:  shared memory area to write the recorded frames to (ARGB, the size of the camera frame)" << std::endl;
+    std::cerr << "         --start: seconds into the recording to start at (default 0)" << std::endl;
+    std::cerr << "         --end:   seconds into the recording to stop at (default: the end)" << std::endl;
+    std::cerr << "         --speed: replay this many times faster than recorded (default 1)" << std::endl;
+    std::cerr << "         --info:  print the records, the chunks and the time span of the recording" << std::endl;
+    std::cerr << "Example: " << argv[0] << " --rec=/tmp/task-2.g7rec --cid=111 --name=video0.argb --start=120" << std::endl;
+  }
+  else {
+    const bool VERBOSE{commandlineArguments.count("verbose") != 0};
+    const double START{(commandlineArguments.count("start") != 0) ? std::stod(commandlineArguments["start"]) : 0.0};
+    const double END{(commandlineArguments.count("end") != 0) ? std::stod(commandlineArguments["end"]) : -1.0};
+    const double SPEED{(commandlineArguments.count("speed") != 0) ? std::stod(commandlineArguments["speed"]) : 1.0};
+
+    RecordingReader reader{commandlineArguments["rec"]};
+    if (!reader.valid()) {
+      std::cerr << argv[0] << ": " << commandlineArguments["rec"] << " is not a recording." << std::endl;
+      return retCode;
+    }
+    int64_t const firstUs{reader.firstTimeUs()};
+    if (commandlineArguments.count("info") != 0) {
+      std::cout << commandlineArguments["rec"] << ": " << reader.records() << " records, "
+        << (reader.lastTimeUs() - firstUs) / 1e6 << " s" << std::endl;
+      return 0;
+    }
+
+    auto const seekStart{std::chrono::steady_clock::now()};
+    int64_t const startUs{firstUs + static_cast<int64_t>(START * 1e6)};
+    int64_t const endUs{(END >= 0.0) ? firstUs + static_cast<int64_t>(END * 1e6) : reader.lastTimeUs()};
+    RecordingReader::Position position{reader.seek(startUs)};
+    if (VERBOSE) {
+      std::clog << argv[0] << ": Found " << START << " s into the recording in "
+        << std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - seekStart).count() << " us." << std::endl;
+    }
+
+    cluon::OD4Session od4{static_cast<uint16_t>(std::stoi(commandlineArguments["cid"]))};
+    std::unique_ptr<cluon::SharedMemory> sharedMemory;
+
+    // The records are sent at their recorded pace, counted from the first
+    // one that is replayed.
+    auto const wallStart{std::chrono::steady_clock::now()};
+    RecordView record;
+    while (od4.isRunning() && reader.read(position, record) && record.timeUs <= endUs) {
+      std::this_thread::sleep_until(wallStart + std::chrono::microseconds(
+            static_cast<int64_t>(static_cast<double>(record.timeUs - startUs) / SPEED)));
+
+      if (record.kind == recording::RecordKind::ENVELOPE) {
+        cluon::data::Envelope envelope;
+        if (RecordingReader::envelope(record, envelope)) {
+          od4.send(std::move(envelope));
+        }
+      } else if (record.kind == recording::RecordKind::FRAME && commandlineArguments.count("name") != 0) {
+        recording::FrameHeader header;
+        cv::Mat bgr;
+        if (!RecordingReader::frame(record, header, bgr)) {
+          continue;
+        }
+        if (!sharedMemory) {
+          // Created with the first frame, as only then the size is known;
+          // what is outside the recorded region stays black.
+          sharedMemory.reset(new cluon::SharedMemory{commandlineArguments["name"],
+              static_cast<uint32_t>(header.frameWidth) * header.frameHeight * 4});
+          if (!sharedMemory->valid()) {
+            std::cerr << argv[0] << ": Failed to create shared memory '" << commandlineArguments["name"] << "'." << std::endl;
+            return retCode;
+          }
+          std::clog << argv[0] << ": Created shared memory '" << sharedMemory->name() << " (" << sharedMemory->size() << " bytes)." << std::endl;
+        }
+        sharedMemory->lock();
+        {
+          cv::Mat wrapped(header.frameHeight, header.frameWidth, CV_8UC4, sharedMemory->data());
+          cv::Mat region{wrapped(cv::Rect(header.x, header.y, header.width, header.height))};
+          cv::cvtColor(bgr, region, cv::COLOR_BGR2BGRA);
+          cluon::data::TimeStamp sampleTime;
+          sampleTime.seconds(static_cast<int32_t>(header.sampleTimeUs / 1000000))
+            .microseconds(static_cast<int32_t>(header.sampleTimeUs % 1000000));
+          sharedMemory->setTimeStamp(sampleTime);
+        }
+        sharedMemory->unlock();
+        sharedMemory->notifyAll();
+      }
+    }
+    retCode = 0;
+  }
+  return retCode;
+}